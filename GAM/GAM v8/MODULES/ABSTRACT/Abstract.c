@@ -0,0 +1,238 @@
+#include "Abstract.h"
+#include "../RNG/Rng.h"
+#include "../TBLOCK/TBlock.h"
+#include "../MOD/Mod.h"
+#include "../DATASOURCE/Datasource.h"
+#include "../PRB/PRB.h"
+#include "../FRAME/Frame.h"
+#include "../CHANNEL/Channel.h"
+
+// FUNCIONES CANAL ABSTRACTO
+// SNR temporal -> SNR por RE de datos: el canal fija el ruido con la potencia media de la supertrama y la FFT
+// unitaria del receptor deja esa misma varianza en cada RE, así que la diferencia es -10·log10(potencia media)
+// con REs de datos de energía unitaria. Preámbulo, pilotos y la media de la constelación (con su CP) salen de
+// una supertrama real; la parte aleatoria de los datos se suma en valor esperado
+bool abstract_symbol_snr_offset(const GAMConstellation *constellation, float *offset_db)
+{
+    if (!constellation || !constellation->initialized || !offset_db)
+    {
+        printf("Error: Constelacion no inicializada para el canal abstracto\n");
+        return true;
+    }
+
+    float complex mean_point = 0.0f + 0.0f * I;
+    for (int i = 0; i < constellation->num_points; i++) {   mean_point += constellation->points[i].point;   }
+    mean_point /= (float)constellation->num_points;
+
+    float complex data_symbols[MAX_BLOCK_SYMBOLS];
+    for (int i = 0; i < constellation->symbols_per_block; i++) {   data_symbols[i] = mean_point;   }
+
+    PRB_Grid grids[SUPERFRAME_PRBS];
+    for (int prb = 0; prb < SUPERFRAME_PRBS; prb++)
+    {
+        if (init_prb_grid(&grids[prb]) ||
+            map_data_to_prb(data_symbols, constellation->symbols_per_block, &grids[prb])) return true;
+    }
+
+    float complex frame[SUPERFRAME_SAMPLES];
+    FrameBuilder frame_builder;
+    if (init_superframe_builder(&frame_builder, frame, SUPERFRAME_SAMPLES, SUPERFRAME_PRBS) ||
+        generate_prb_ofdm_into_superframe(grids, SUPERFRAME_PRBS, &frame_builder)) return true;
+
+    // Cada RE aleatorio reparte 1 - |media|^2 entre las N_FFT muestras del cuerpo; el CP repite CP_LEN de ellas
+    float mean_energy = crealf(mean_point) * crealf(mean_point) + cimagf(mean_point) * cimagf(mean_point);
+    float random_energy = (float)SUPERFRAME_PRBS * constellation->symbols_per_block * (1.0f - mean_energy) *
+                          (float)(N_FFT + CP_LEN) / (float)N_FFT;
+    float mean_power = calculate_mean_power(frame, SUPERFRAME_SAMPLES) + random_energy / SUPERFRAME_SAMPLES;
+
+    *offset_db = -10.0f * log10f(mean_power);
+
+    return false;
+}
+
+bool init_abstract_channel(AbstractChannel *channel, AbstractChannelModel model, float snr_db,
+                           float symbol_snr_offset_db, uint64_t seed)
+{
+    if (!channel)
+    {
+        printf("Error: Canal abstracto no valido\n");
+        return true;
+    }
+
+    channel->model = model;
+    channel->snr_db = snr_db;
+    channel->symbol_snr_db = snr_db + symbol_snr_offset_db;
+    channel->bad_state = false;
+    channel->seed = seed;
+    channel->symbols = 0;
+    channel->bad_symbols = 0;
+
+    if (init_rng(&channel->rng, seed)) return true;
+    if (configure_gilbert_elliott(channel, GE_BAD_SNR_PENALTY_DB, GE_P_GOOD_TO_BAD, GE_P_BAD_TO_GOOD)) return true;
+
+    channel->initialized = true;
+
+    return false;
+}
+
+bool configure_gilbert_elliott(AbstractChannel *channel, float bad_snr_penalty_db, float p_good_to_bad,
+                               float p_bad_to_good)
+{
+    if (!channel || p_good_to_bad < 0.0f || p_good_to_bad > 1.0f || p_bad_to_good <= 0.0f || p_bad_to_good > 1.0f)
+    {
+        printf("Error: Parametros Gilbert-Elliott invalidos\n");
+        return true;
+    }
+
+    channel->bad_snr_db = channel->symbol_snr_db - bad_snr_penalty_db;
+    channel->p_good_to_bad = p_good_to_bad;
+    channel->p_bad_to_good = p_bad_to_good;
+
+    return false;
+}
+
+// Constelación de energía media unitaria (init_golden_modulation normaliza): sigma^2 = 1 / SNR por componente x2
+bool abstract_channel_symbols(AbstractChannel *channel, const float complex in_symbols[],
+                              float complex out_symbols[], int length)
+{
+    if (!channel || !channel->initialized)
+    {
+        printf("Error: Canal abstracto no inicializado\n");
+        return true;
+    }
+
+    float good_stddev = sqrtf(0.5f / powf(10.0f, channel->symbol_snr_db / 10.0f));
+    float bad_stddev = sqrtf(0.5f / powf(10.0f, channel->bad_snr_db / 10.0f));
+
+    if (channel->model == ABSTRACT_AWGN)
+    {
+        float complex noise[MAX_BLOCK_SYMBOLS];
+        for (int start = 0; start < length; start += MAX_BLOCK_SYMBOLS)
+        {
+            int count = (length - start < MAX_BLOCK_SYMBOLS) ? length - start : MAX_BLOCK_SYMBOLS;
+            rng_fill_complex_gaussian(&channel->rng, noise, count, good_stddev);
+            for (int i = 0; i < count; i++) {   out_symbols[start + i] = in_symbols[start + i] + noise[i];   }
+        }
+    }
+    else
+    {
+        // Estado por símbolo; persiste entre llamadas (simulate_abstract_block lo sortea al empezar cada bloque)
+        for (int i = 0; i < length; i++)
+        {
+            float u = rng_uniform(&channel->rng);
+            if (channel->bad_state) { if (u < channel->p_bad_to_good) channel->bad_state = false; }
+            else                    { if (u < channel->p_good_to_bad) channel->bad_state = true; }
+
+            float stddev = channel->bad_state ? bad_stddev : good_stddev;
+            if (channel->bad_state) channel->bad_symbols++;
+
+            out_symbols[i] = in_symbols[i] + (rng_gaussian(&channel->rng) + rng_gaussian(&channel->rng) * I) * stddev;
+        }
+    }
+
+    channel->symbols += length;
+
+    return false;
+}
+
+bool simulate_abstract_block(AbstractChannel *channel, long long block, const GAMConstellation *constellation,
+                             TransportBlock *tx_tb, TransportBlock *rx_tb)
+{
+    if (!channel || !channel->initialized || !constellation || !tx_tb || !rx_tb)
+    {
+        printf("Error: Canal abstracto no inicializado\n");
+        return true;
+    }
+
+    // Datos y ruido en flujos propios del bloque: cualquier bloque del barrido es reproducible
+    int data_bits[TB_SIZE_BITS];
+    if (generate_frame_bits(channel->seed, block, 0, &channel->rng, data_bits)) return true;
+    if (build_transport_block(tx_tb, data_bits)) return true;
+
+    const int num_symbols = constellation->symbols_per_block;
+    float complex tx_symbols[MAX_BLOCK_SYMBOLS], rx_symbols[MAX_BLOCK_SYMBOLS];
+    if (gam_modulate_block(constellation, tx_tb->interleaved_bits, tx_symbols)) return true;
+
+    if (set_rng_stream(&channel->rng, channel->seed, (uint64_t)block, RNG_STAGE_NOISE, 0)) return true;
+
+    // Estado inicial del bloque desde su propio flujo, con la distribución estacionaria de la cadena:
+    // el bloque no depende del anterior
+    if (channel->model == ABSTRACT_GILBERT_ELLIOTT)
+    {
+        float p_bad = channel->p_good_to_bad / (channel->p_good_to_bad + channel->p_bad_to_good);
+        channel->bad_state = rng_uniform(&channel->rng) < p_bad;
+    }
+    if (abstract_channel_symbols(channel, tx_symbols, rx_symbols, num_symbols)) return true;
+
+    // El resultado del CRC queda en rx_tb->crc_valid (el retorno solo indica CRC inválido)
+#if SOFT_DECODING
+    float noise_variance = 1.0f / powf(10.0f, channel->symbol_snr_db / 10.0f);
+    float rx_llrs[MAX_BLOCK_BITS];
+    if (gam_demodulate_llr(constellation, rx_symbols, num_symbols, noise_variance, false, rx_llrs)) return true;
+
+    process_received_block_soft(rx_llrs, rx_tb);
+#else
+    int rx_interleaved_bits[MAX_BLOCK_BITS];
+    if (gam_demodulate_hard(constellation, rx_symbols, num_symbols, rx_interleaved_bits)) return true;
+
+    process_received_block(rx_interleaved_bits, rx_tb);
+#endif
+
+    return false;
+}
+
+bool run_abstract_sweep(AbstractChannelModel model, int bits_per_symbol, float snr_start, float snr_stop,
+                        float snr_step, int blocks_per_point, uint64_t seed)
+{
+    if (snr_step <= 0.0f || blocks_per_point <= 0)
+    {
+        printf("Error: Barrido abstracto invalido\n");
+        return true;
+    }
+
+    const GAMConstellation *constellation = get_gam_constellation(bits_per_symbol);
+    if (!constellation) return true;
+
+    float symbol_snr_offset_db;
+    if (abstract_symbol_snr_offset(constellation, &symbol_snr_offset_db)) return true;
+
+    printf("\n=== BARRIDO CANAL ABSTRACTO (%s, %d-GAM, %d bloques por punto) ===\n",
+           model == ABSTRACT_AWGN ? "AWGN" : "Gilbert-Elliott", constellation->num_points, blocks_per_point);
+    printf("  SNR por RE = SNR temporal %+.2f dB (supertrama de %d muestras)\n",
+           symbol_snr_offset_db, SUPERFRAME_SAMPLES);
+    printf("  SNR(dB)  SNR RE(dB)       BER      BLER  Malos(%%)   Bloques/s\n");
+
+    for (float snr = snr_start; snr <= snr_stop + 1e-3f; snr += snr_step)
+    {
+        AbstractChannel channel;
+        if (init_abstract_channel(&channel, model, snr, symbol_snr_offset_db, seed)) return true;
+
+        long long bit_errors = 0;
+        int block_errors = 0;
+        struct timespec start_time, end_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+        for (int block = 0; block < blocks_per_point; block++)
+        {
+            TransportBlock tx_tb, rx_tb;
+            if (simulate_abstract_block(&channel, block, constellation, &tx_tb, &rx_tb)) return true;
+
+            for (int i = 0; i < TB_SIZE_BITS; i++)
+            {
+                if (tx_tb.data_bits[i] != rx_tb.data_bits[i]) bit_errors++;
+            }
+            if (!rx_tb.crc_valid) block_errors++;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        double elapsed = (double)(end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+        printf("  %7.2f  %10.2f  %.2e  %.2e  %8.2f  %10.0f\n", snr, channel.symbol_snr_db,
+               (double)bit_errors / ((double)blocks_per_point * TB_SIZE_BITS),
+               (double)block_errors / blocks_per_point,
+               channel.symbols > 0 ? 100.0 * channel.bad_symbols / channel.symbols : 0.0,
+               elapsed > 0 ? blocks_per_point / elapsed : 0.0);
+    }
+
+    return false;
+}
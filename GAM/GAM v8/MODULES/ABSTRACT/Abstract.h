@@ -0,0 +1,29 @@
+#ifndef GAM_ABSTRACT_H
+#define GAM_ABSTRACT_H
+
+#include "../../MODULES/Common.h"
+
+
+// CANAL ABSTRACTO A NIVEL DE SÍMBOLO (AWGN / Gilbert-Elliott)
+// Diferencia SNR por RE de datos - SNR temporal de la supertrama real con esta constelación
+bool abstract_symbol_snr_offset(const GAMConstellation *constellation, float *offset_db);
+
+bool init_abstract_channel(AbstractChannel *channel, AbstractChannelModel model, float snr_db,
+                           float symbol_snr_offset_db, uint64_t seed);
+
+bool configure_gilbert_elliott(AbstractChannel *channel, float bad_snr_penalty_db, float p_good_to_bad,
+                               float p_bad_to_good);
+
+bool abstract_channel_symbols(AbstractChannel *channel, const float complex in_symbols[],
+                              float complex out_symbols[], int length);
+
+
+// BLOQUE DE TRANSPORTE COMPLETO SIN CAPA FÍSICA (build_transport_block -> process_received_block)
+bool simulate_abstract_block(AbstractChannel *channel, long long block, const GAMConstellation *constellation,
+                             TransportBlock *tx_tb, TransportBlock *rx_tb);
+
+bool run_abstract_sweep(AbstractChannelModel model, int bits_per_symbol, float snr_start, float snr_stop,
+                        float snr_step, int blocks_per_point, uint64_t seed);
+
+
+#endif //GAM_ABSTRACT_H
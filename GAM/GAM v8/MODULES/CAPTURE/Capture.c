@@ -0,0 +1,334 @@
+#include "Capture.h"
+#include "../PRB/PRB.h"
+#include "../RECEIVER/Receiver.h"
+#include "../MOD/Mod.h"
+#include "../FRAME/Frame.h"
+#include "../TBLOCK/TBlock.h"
+#include "../DATASOURCE/Datasource.h"
+#include "../CHANNEL/Channel.h"
+#include "../RNG/Rng.h"
+
+#define CAPTURE_FRAME_SAMPLES SUPERFRAME_SAMPLES
+#define CAPTURE_PUSH_SAMPLES 4096
+
+// FUNCIONES DECODIFICACIÓN PARALELA
+int capture_default_threads(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    int threads = (int)info.dwNumberOfProcessors;
+    if (threads < 1) threads = 1;
+    if (threads > MAXIMUM_WAIT_OBJECTS) threads = MAXIMUM_WAIT_OBJECTS;
+
+    return threads;
+}
+
+// Guarda solo los bloques cuyo preámbulo empieza en la zona propia del trozo
+static void collect_chunk_block(const TransportBlock *tb, long long frame_start_sample, int block_index,
+                                void *user_data)
+{
+    CaptureChunk *chunk = user_data;
+    long long frame_start = chunk->start + frame_start_sample;
+    long long preamble_start = frame_start - PREAMBLE_LEN;
+
+    if (preamble_start < chunk->start || preamble_start >= chunk->core_end) return;
+
+    if (chunk->num_blocks == chunk->capacity)
+    {
+        int capacity = chunk->capacity ? 2 * chunk->capacity : 16;
+        DecodedBlock *blocks = realloc(chunk->blocks, (size_t)capacity * sizeof(DecodedBlock));
+        if (!blocks)
+        {
+            chunk->error = true;
+            return;
+        }
+        chunk->blocks = blocks;
+        chunk->capacity = capacity;
+    }
+
+    chunk->blocks[chunk->num_blocks].tb = *tb;
+    chunk->blocks[chunk->num_blocks].frame_start = frame_start;
+    chunk->blocks[chunk->num_blocks].block_index = block_index;
+    chunk->num_blocks++;
+}
+
+// Cada trozo usa su propio receptor streaming (buffer, correlador y trackers independientes)
+static void decode_capture_chunk(CaptureChunk *chunk)
+{
+    StreamReceiver receiver;
+    if (init_stream_receiver(&receiver, collect_chunk_block, chunk))
+    {
+        chunk->error = true;
+        return;
+    }
+
+    for (long long position = chunk->start; position < chunk->end; position += CAPTURE_PUSH_SAMPLES)
+    {
+        long long count = chunk->end - position;
+        if (count > CAPTURE_PUSH_SAMPLES) count = CAPTURE_PUSH_SAMPLES;
+
+        if (stream_receiver_push(&receiver, &chunk->capture[position], (int)count))
+        {
+            chunk->error = true;
+            break;
+        }
+    }
+
+    free_stream_receiver(&receiver);
+}
+
+static DWORD WINAPI capture_worker(LPVOID argument)
+{
+    CaptureJob *job = argument;
+
+    // Reparto dinámico: cada hilo toma el siguiente trozo libre
+    while (true)
+    {
+        LONG index = InterlockedIncrement(&job->next_chunk) - 1;
+        if (index >= job->num_chunks) break;
+
+        decode_capture_chunk(&job->chunks[index]);
+    }
+
+    free_prb_batch_scratch();
+
+    return 0;
+}
+
+bool decode_capture_parallel(const float complex capture[], long long length, int num_threads,
+                             TransportBlockCallback on_block, void *user_data, int *blocks_decoded)
+{
+    if (!capture || length <= 0 || !on_block)
+    {
+        printf("Error: Parametros invalidos para decodificacion de captura\n");
+        return true;
+    }
+
+    if (num_threads <= 0) num_threads = capture_default_threads();
+    if (num_threads > MAXIMUM_WAIT_OBJECTS) num_threads = MAXIMUM_WAIT_OBJECTS;
+
+    // Los planes FFT y la constelación compartidos se crean aquí, no en paralelo desde los hilos
+    if (init_prb_ofdm_plans() || !default_gam_constellation()) return true;
+
+    // Zona propia de cada trozo; el solape de una trama garantiza tramas completas
+    long long core_length = (length + (long long)num_threads * CAPTURE_CHUNKS_PER_THREAD - 1) /
+                            ((long long)num_threads * CAPTURE_CHUNKS_PER_THREAD);
+    if (core_length < CAPTURE_MIN_CHUNK_SAMPLES) core_length = CAPTURE_MIN_CHUNK_SAMPLES;
+
+    int num_chunks = (int)((length + core_length - 1) / core_length);
+    CaptureChunk *chunks = calloc((size_t)num_chunks, sizeof(CaptureChunk));
+    if (!chunks)
+    {
+        printf("Error: Sin memoria para %d trozos de captura\n", num_chunks);
+        return true;
+    }
+
+    for (int i = 0; i < num_chunks; i++)
+    {
+        chunks[i].capture = capture;
+        chunks[i].start = (long long)i * core_length;
+        chunks[i].core_end = chunks[i].start + core_length;
+        if (chunks[i].core_end > length) chunks[i].core_end = length;
+        chunks[i].end = chunks[i].core_end + CAPTURE_FRAME_SAMPLES;
+        if (chunks[i].end > length) chunks[i].end = length;
+    }
+
+    CaptureJob job;
+    job.chunks = chunks;
+    job.num_chunks = num_chunks;
+    job.next_chunk = 0;
+
+    if (num_threads > num_chunks) num_threads = num_chunks;
+    printf("Captura: %lld muestras en %d trozos, %d hilos\n", length, num_chunks, num_threads);
+
+    HANDLE threads[MAXIMUM_WAIT_OBJECTS];
+    int started = 0;
+    for (int t = 0; t < num_threads; t++)
+    {
+        threads[started] = CreateThread(NULL, 0, capture_worker, &job, 0, NULL);
+        if (threads[started]) started++;
+    }
+
+    // Sin hilos disponibles el trabajo se hace en el hilo actual
+    if (started == 0) capture_worker(&job);
+    else WaitForMultipleObjects((DWORD)started, threads, TRUE, INFINITE);
+
+    for (int t = 0; t < started; t++) { CloseHandle(threads[t]); }
+
+    // Entrega en orden de captura, descartando duplicados en las fronteras de los trozos
+    bool error = false;
+    int delivered = 0;
+    long long last_frame_start = -1;
+
+    for (int i = 0; i < num_chunks; i++)
+    {
+        if (chunks[i].error)
+        {
+            printf("Error: Fallo al decodificar el trozo %d [%lld, %lld)\n", i, chunks[i].start, chunks[i].end);
+            error = true;
+        }
+
+        for (int b = 0; b < chunks[i].num_blocks; b++)
+        {
+            const DecodedBlock *block = &chunks[i].blocks[b];
+            if (last_frame_start >= 0 && block->frame_start != last_frame_start &&
+                block->frame_start - last_frame_start < CAPTURE_FRAME_SAMPLES / 2) continue;
+
+            on_block(&block->tb, block->frame_start, block->block_index, user_data);
+            last_frame_start = block->frame_start;
+            delivered++;
+        }
+
+        free(chunks[i].blocks);
+    }
+
+    free(chunks);
+
+    if (blocks_decoded) *blocks_decoded = delivered;
+
+    return error;
+}
+
+
+// FUNCIONES CAPTURA SINTÉTICA
+// Supertramas de la cadena real, cada una precedida de gap_samples de silencio, con AWGN sobre toda la captura
+static bool synthesize_capture(const GAMConstellation *constellation, int num_frames, int gap_samples,
+                               uint64_t seed, float complex capture[], long long length, int tx_bits[])
+{
+    RngState rng;
+    double signal_energy = 0.0;
+
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        PRB_Grid grids[SUPERFRAME_PRBS];
+        for (int prb = 0; prb < SUPERFRAME_PRBS; prb++)
+        {
+            int *bits = &tx_bits[((size_t)frame * SUPERFRAME_PRBS + prb) * TB_SIZE_BITS];
+            TransportBlock tb;
+            float complex symbols[MAX_BLOCK_SYMBOLS];
+
+            if (generate_frame_bits(seed, frame, prb, &rng, bits) ||
+                build_transport_block(&tb, bits) ||
+                gam_modulate_block(constellation, tb.interleaved_bits, symbols) ||
+                init_prb_grid(&grids[prb]) ||
+                map_data_to_prb(symbols, constellation->symbols_per_block, &grids[prb])) return true;
+        }
+
+        long long offset = (long long)(frame + 1) * gap_samples + (long long)frame * SUPERFRAME_SAMPLES;
+        FrameBuilder builder;
+        if (init_superframe_builder(&builder, &capture[offset], SUPERFRAME_SAMPLES, SUPERFRAME_PRBS) ||
+            generate_prb_ofdm_into_superframe(grids, SUPERFRAME_PRBS, &builder)) return true;
+
+        signal_energy += (double)calculate_mean_power(&capture[offset], SUPERFRAME_SAMPLES) * SUPERFRAME_SAMPLES;
+    }
+
+    // Ruido fijado por la potencia media de las supertramas, igual que awgn_channel_frame
+    float mean_power = (float)(signal_energy / ((double)num_frames * SUPERFRAME_SAMPLES));
+    float stddev = sqrtf(mean_power / powf(10.0f, SNR / 10.0f) / 2.0f);
+
+    if (set_rng_stream(&rng, seed, 0, RNG_STAGE_NOISE, 0)) return true;
+
+    float complex noise[CAPTURE_PUSH_SAMPLES];
+    for (long long start = 0; start < length; start += CAPTURE_PUSH_SAMPLES)
+    {
+        int count = (length - start < CAPTURE_PUSH_SAMPLES) ? (int)(length - start) : CAPTURE_PUSH_SAMPLES;
+        rng_fill_complex_gaussian(&rng, noise, count, stddev);
+        for (int i = 0; i < count; i++) {   capture[start + i] += noise[i];   }
+    }
+
+    return false;
+}
+
+// Cada bloque entregado se sitúa en la rejilla de supertramas y se compara con los bits enviados
+static void check_capture_block(const TransportBlock *tb, long long frame_start_sample, int block_index,
+                                void *user_data)
+{
+    CaptureCheck *check = user_data;
+    check->blocks_received++;
+
+    long long offset = frame_start_sample - PREAMBLE_LEN - check->first_preamble;
+    long long frame = (offset + check->frame_period / 2) / check->frame_period;
+    long long error = offset - frame * check->frame_period;
+
+    if (offset < -CP_LEN || frame >= check->num_frames || error < -CP_LEN || error > CP_LEN ||
+        block_index < 0 || block_index >= SUPERFRAME_PRBS)
+    {
+        check->blocks_misplaced++;
+        return;
+    }
+
+    const int *bits = &check->tx_bits[((size_t)frame * SUPERFRAME_PRBS + block_index) * TB_SIZE_BITS];
+    if (!tb->crc_valid) return;
+
+    for (int i = 0; i < TB_SIZE_BITS; i++)
+    {
+        if (tb->data_bits[i] != bits[i]) return;
+    }
+    check->blocks_correct++;
+}
+
+bool run_capture_benchmark(int num_frames, int gap_samples, uint64_t seed)
+{
+    if (num_frames <= 0 || gap_samples < 0)
+    {
+        printf("Error: Captura sintetica invalida\n");
+        return true;
+    }
+
+    const GAMConstellation *constellation = default_gam_constellation();
+    if (!constellation || init_prb_ofdm_plans()) return true;
+
+    long long frame_period = (long long)gap_samples + SUPERFRAME_SAMPLES;
+    long long length = (long long)num_frames * frame_period + gap_samples;
+    int total_blocks = num_frames * SUPERFRAME_PRBS;
+
+    float complex *capture = calloc((size_t)length, sizeof(float complex));
+    int *tx_bits = malloc((size_t)total_blocks * TB_SIZE_BITS * sizeof(int));
+    if (!capture || !tx_bits)
+    {
+        printf("Error: Sin memoria para captura sintetica de %lld muestras\n", length);
+        free(capture);
+        free(tx_bits);
+        return true;
+    }
+
+    bool error = synthesize_capture(constellation, num_frames, gap_samples, seed, capture, length, tx_bits);
+    if (!error)
+    {
+        printf("\n=== CAPTURA SINTETICA (%d supertramas, %lld muestras = %.3f s, SNR %.1f dB) ===\n",
+               num_frames, length, length / SAMPLE_RATE_HZ, SNR);
+    }
+
+    // Referencia secuencial y después todos los hilos disponibles
+    int thread_counts[2] = { 1, capture_default_threads() };
+    int num_runs = (thread_counts[1] > 1) ? 2 : 1;
+    double sequential_time = 0.0;
+
+    for (int run = 0; run < num_runs && !error; run++)
+    {
+        CaptureCheck check = { tx_bits, num_frames, gap_samples, frame_period, 0, 0, 0 };
+        int blocks_decoded = 0;
+        struct timespec start_time, end_time;
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        error = decode_capture_parallel(capture, length, thread_counts[run], check_capture_block, &check,
+                                        &blocks_decoded);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        double elapsed = (double)(end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+        if (run == 0) sequential_time = elapsed;
+
+        printf("  Hilos %2d: %d/%d bloques correctos (%d entregados, %d fuera de rejilla) | %.3f s | "
+               "%.1f Mmuestras/s | x%.1f tiempo real | aceleracion x%.2f\n",
+               thread_counts[run], check.blocks_correct, total_blocks, blocks_decoded, check.blocks_misplaced,
+               elapsed, elapsed > 0 ? length / elapsed / 1e6 : 0.0,
+               elapsed > 0 ? length / SAMPLE_RATE_HZ / elapsed : 0.0,
+               elapsed > 0 ? sequential_time / elapsed : 0.0);
+    }
+
+    free(capture);
+    free(tx_bits);
+
+    return error;
+}
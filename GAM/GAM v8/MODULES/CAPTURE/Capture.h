@@ -0,0 +1,17 @@
+#ifndef GAM_CAPTURE_H
+#define GAM_CAPTURE_H
+
+#include "../../MODULES/Common.h"
+
+
+// DECODIFICACIÓN PARALELA DE UNA CAPTURA LARGA (trozos solapados una trama, un hilo por trozo)
+int capture_default_threads(void);
+
+bool decode_capture_parallel(const float complex capture[], long long length, int num_threads,
+                             TransportBlockCallback on_block, void *user_data, int *blocks_decoded);
+
+// Captura sintética (supertramas reales separadas por ruido) decodificada con 1 hilo y con todos
+bool run_capture_benchmark(int num_frames, int gap_samples, uint64_t seed);
+
+
+#endif //GAM_CAPTURE_H
@@ -5,11 +5,45 @@
 
 
 // MODELADO DE CANAL
+bool seed_channel_noise(uint64_t seed);
+
 float complex awgn_noise(float stddev);
 
+void fill_awgn_noise(float complex noise[], int length, float stddev);
+
 float calculate_mean_power(const float complex symbols[], int length);
 
 bool awgn_channel(float complex in_symbols[], float complex out_symbols[], int length);
 
+bool awgn_channel_frame(const float complex in_symbols[], float complex out_symbols[], int length,
+                        uint64_t seed, long long frame, RngState *rng);
+
+
+// CANAL MULTITRAYECTO TDL (Rayleigh / Rician, Doppler por suma de sinusoides)
+bool init_tdl_channel(TDLChannel *tdl, const float delays_ns[], const float powers_db[], int num_paths,
+                      float doppler_hz, float rician_k);
+
+bool init_tdl_profile(TDLChannel *tdl, TDLProfile profile, float doppler_hz, float rician_k);
+
+void free_tdl_channel(TDLChannel *tdl);
+
+bool tdl_fading(TDLChannel *tdl, const float complex in_symbols[], float complex out_symbols[], int length,
+                uint64_t seed, long long frame, RngState *rng);
+
+bool tdl_channel_frame(TDLChannel *tdl, const float complex in_symbols[], float complex out_symbols[], int length,
+                       uint64_t seed, long long frame, RngState *rng);
+
+
+// IMPERFECCIONES RF (CFO por NCO, ruido de fase de Wiener, SCO por remuestreo Farrow en streaming)
+bool init_rf_impairments(RFImpairments *rf, float cfo_hz, float linewidth_hz, float sco_ppm);
+
+void reset_rf_impairments(RFImpairments *rf);
+
+bool rf_impairments_process(RFImpairments *rf, RngState *rng, const float complex in_symbols[], int in_length,
+                            float complex out_symbols[], int max_out, int *consumed, int *produced);
+
+bool rf_impairments_frame(RFImpairments *rf, const float complex in_symbols[], float complex out_symbols[],
+                          int length, uint64_t seed, long long frame, RngState *rng);
+
 
 #endif //GAM_CHANNEL_H
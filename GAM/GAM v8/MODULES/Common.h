@@ -31,8 +31,11 @@
 #define TOTAL_BITS (TB_SIZE_BITS + CRC_TYPE) // 72 bits total
 #define REPETITION_FACTOR 3
 #define TOTAL_BITS_REPEATED (TOTAL_BITS * REPETITION_FACTOR) // 216 bits
-#define BPS 4                     // 2 bits por símbolo (QPSK-like)
-#define TOTAL_SYMBOLS (TOTAL_BITS_REPEATED / BPS) // 108 símbolos de datos
+#define DEFAULT_BPS 4             // Orden por defecto; cada trama puede usar cualquiera en [MIN_BPS, MAX_BPS]
+#define MIN_BPS 2
+#define MAX_BPS 12
+#define MAX_BLOCK_SYMBOLS ((TOTAL_BITS_REPEATED + MIN_BPS - 1) / MIN_BPS) // 108 símbolos con MIN_BPS
+#define MAX_BLOCK_BITS (TOTAL_BITS_REPEATED + MAX_BPS - 1) // Bits del bloque con relleno del último símbolo
 
 
 // PARÁMETROS PILOTOS EN PRB
@@ -49,23 +52,112 @@
 
 // PARÁMETROS MODULACIÓN
 #define ANGLE_STEP 2.3997569
-#define C_POINTS (1 << BPS)
+#define MAX_C_POINTS (1 << MAX_BPS)
+#define GRAY_INDEX_MAX_BPS 4                     // Hasta este orden, Gray sobre el índice (tablas de mapeo de 2-4 bits)
+#define LABEL_NEIGHBOURS 8                       // Vecinos geométricos por punto en el etiquetado de órdenes altos
+#define LABEL_MAX_CANDIDATES 64                  // Candidatos por punto: distancias de índice de Fibonacci
+#define LABEL_NEIGHBOUR_RADIUS 1.6               // Vecindad relativa a la distancia al punto más cercano
+#define LABEL_WEIGHT_DECAY 3.0                   // Peso de cada vecino: exp(-decay * (d^2 / d_min^2 - 1))
+#define LABEL_WEIGHT_SCALE 64                    // Pesos enteros: etiquetas idénticas en cualquier plataforma
+#define LABEL_MAX_PASSES 20                      // Pasadas de intercambios de etiquetas entre vecinos
+#define DECISION_GRID_SIZE 64                    // Celdas por eje de la rejilla de decisión I/Q
+#define DECISION_GRID_MAX_CANDIDATES 4           // Candidatos por celda (más: búsqueda exhaustiva)
+#define DECISION_GRID_EXTENT 1.25f               // Semilado de la rejilla relativo al radio máximo
+#define SOFT_DECODING 1                          // 1: LLR max-log + combinación de repeticiones; 0: decisión dura
+#define LLR_BLOCK 64                             // Símbolos por bloque del demapeador (vectorizado entre símbolos)
+#define LLR_MIN_NOISE_VARIANCE_POINTS 1.6e-3f    // Suelo de la varianza de ruido por número de puntos (1e-4 en 16-GAM)
+#define LLR_SATURATION 20.0f                     // |LLR| máximo: acota también el radio de búsqueda del índice
+#define SPATIAL_INDEX_MIN_POINTS 256             // Órdenes desde los que decisión y LLR usan el índice espacial
+#define SPATIAL_POINTS_PER_CELL 2                // Ocupación media objetivo de cada celda (anillo, sector)
+#define SPATIAL_MAX_RINGS 64
+#define SPATIAL_MAX_CELLS (MAX_C_POINTS + 4 * SPATIAL_MAX_RINGS)
+#define SPATIAL_BOUND_SLACK (1.0f - 1e-4f)       // Margen de las cotas de celda frente al redondeo
 
 
 // PARÁMETROS OFDM
 #define N_FFT 128
 #define CP_LEN 10
 #define SUBCARRIERS_START (N_FFT/2 - PRB_SUBCARRIERS/2) // Centrar PRB en FFT
+#define PRB_PAYLOAD_SAMPLES (PRB_SYMBOLS * (N_FFT + CP_LEN)) // Muestras de un PRB con CP
+#define SUPERFRAME_PRBS 1                        // PRBs (bloques de transporte) tras cada preámbulo
+#define SUPERFRAME_SAMPLES (PREAMBLE_LEN + SUPERFRAME_PRBS * PRB_PAYLOAD_SAMPLES)
 
 
 // PARÁMETROS CANAL
 #define SNR 6.0
+#define CHANNEL_NOISE_SEED 0x5EED5EED5EEDULL      // Semilla por defecto del generador de ruido
+#define ZIGGURAT_LAYERS 128                      // Capas del Ziggurat normal (Marsaglia-Tsang)
+#define SIMULATION_SEED 0x6A4D5EEDULL            // Semilla de la simulación: (semilla, trama, etapa) -> flujo
+#define PHILOX_ROUNDS 10                         // Rondas de Philox4x32 (10 = variante estándar)
+
+
+// PARÁMETROS CANAL MULTITRAYECTO (TDL, perfiles 3GPP TS 36.104 anexo B)
+#define SAMPLE_RATE_HZ (15000.0 * N_FFT)         // 15 kHz de separación entre subportadoras
+#define TDL_FADING 0                             // 1: canal TDL con desvanecimiento antes del AWGN
+#define TDL_DEFAULT_PROFILE TDL_EPA
+#define TDL_DOPPLER_HZ 5.0                       // Doppler máximo (EPA 5 Hz, EVA 70 Hz, ETU 300 Hz)
+#define TDL_RICIAN_K 0.0                         // K lineal del primer trayecto (0 = Rayleigh)
+#define TDL_MAX_TAPS 64                          // Trayectos tras cuantizar los retardos a muestras
+#define TDL_SINUSOIDS 16                         // Sinusoides por trayecto (suma de sinusoides)
+#define TDL_GAIN_UPDATE 64                       // Muestras entre evaluaciones exactas de las ganancias
+#define TDL_DIRECT_MAX_TAPS 24                   // Por encima: convolución FFT overlap-save
+
+
+// PARÁMETROS IMPERFECCIONES RF (osciladores y reloj de muestreo)
+#define RF_IMPAIRMENTS 0                         // 1: CFO + ruido de fase + SCO antes del canal
+#define RF_CFO_HZ 150.0                          // Desplazamiento de portadora
+#define RF_PHASE_NOISE_LINEWIDTH_HZ 10.0         // Ancho de línea a -3 dB del ruido de fase de Wiener
+#define RF_SCO_PPM 20.0                          // Error del reloj de muestreo (partes por millón)
+#define RF_IMPAIRMENT_BLOCK 256                  // Muestras de ruido de fase generadas por lote
+#define RF_NCO_TABLE_BITS 10                     // Tabla seno/coseno del NCO (2^bits entradas, interpolada)
+
+
+// PARÁMETROS CANAL ABSTRACTO (bits entrelazados -> símbolos -> canal -> bloque, sin OFDM/PRB/sync)
+#define ABSTRACT_CHANNEL_MODE 0                  // 1: barrido rápido de la capa de codificación en lugar de la cadena
+#define ABSTRACT_BLOCKS_PER_POINT 20000          // Bloques de transporte por punto del barrido
+#define ABSTRACT_SNR_START 0.0                   // SNR por muestra temporal, como SNR (dB)
+#define ABSTRACT_SNR_STOP 10.0
+#define ABSTRACT_SNR_STEP 1.0
+#define GE_P_GOOD_TO_BAD 0.01                    // Gilbert-Elliott: transición por símbolo
+#define GE_P_BAD_TO_GOOD 0.2
+#define GE_BAD_SNR_PENALTY_DB 15.0               // Pérdida de SNR en el estado malo
 
 
 // PARÁMETROS PREÁMBULO
 #define PREAMBLE_LEN 32
 #define PREAMBLE_SYNC_WORD 0x2A9A5F3C
 #define CORRELATION_THRESHOLD 0.7
+#define OVERLAP_SAVE_BLOCK (8 * PREAMBLE_LEN)    // Tamaño FFT por defecto del correlador por bloques
+#define COARSE_CANDIDATES 32                     // Candidatos de la etapa 1-bit que pasan al refinado float
+#define PREAMBLE_REPEATED_HALF 0                 // 1: dos mitades idénticas (timing + CFO Schmidl-Cox)
+#define SCHMIDL_COX_THRESHOLD 0.6                // Umbral de la métrica |P|^2 / (E1 E2), en [0, 1]
+#define CFO_SIGNIFICANCE 4.0                     // Solo se corrige un CFO mayor que k desviaciones típicas
+#define CFO_BANK_FFT_SIZE (2 * PREAMBLE_LEN)     // Hipótesis de CFO separadas 2π / tamaño rad/muestra
+#define CFO_BANK_MAX_CFO 0.8                     // CFO máximo buscado por el banco (rad/muestra)
+#define CFO_BANK_BATCH 16                        // Desplazamientos evaluados por FFT en lote
+
+
+// PARÁMETROS CFAR (umbral adaptativo sobre |correlación|^2)
+#define CFAR_REFERENCE_CELLS 32                  // Celdas de referencia a cada lado de la celda bajo test
+#define CFAR_GUARD_CELLS 4                       // Celdas de guarda a cada lado (lóbulos del pico)
+#define CFAR_FALSE_ALARM_RATE 1e-4               // Probabilidad de falsa alarma por celda objetivo
+#define CFAR_OS_RANK 0.75                        // Orden k = rango * n de las celdas para OS-CFAR
+
+
+// PARÁMETROS DETECCIÓN DE ENERGÍA (compuerta previa a la correlación)
+#define ENERGY_WINDOW PREAMBLE_LEN               // Muestras de la media móvil de potencia
+#define ENERGY_ON_DB 3.0                         // Apertura: potencia sobre el suelo de ruido (dB)
+#define ENERGY_OFF_DB 1.5                        // Cierre (histéresis): potencia sobre el suelo (dB)
+#define ENERGY_GUARD_SAMPLES (2 * PREAMBLE_LEN)  // Margen antes/después del segmento activo
+#define ENERGY_FLOOR_ALPHA 0.001                 // Seguimiento del suelo (en reposo; activo solo hacia abajo)
+
+
+// PARÁMETROS DECODIFICACIÓN PARALELA DE CAPTURAS
+#define CAPTURE_MODE 0                           // 1: captura sintética multi-trama por decode_capture_parallel
+#define CAPTURE_FRAMES 256                       // Supertramas de la captura sintética
+#define CAPTURE_GAP_SAMPLES SUPERFRAME_SAMPLES   // Ruido sin señal antes de cada supertrama (compuerta de energía)
+#define CAPTURE_CHUNKS_PER_THREAD 4              // Trozos por hilo (reparto dinámico de carga)
+#define CAPTURE_MIN_CHUNK_SAMPLES (16 * SUPERFRAME_SAMPLES) // Limita el coste del solape
 
 
 // PARÁMETROS PILOTOS
@@ -81,9 +173,83 @@
 // ESTRUCTURAS GLOBALES
 typedef struct {
     float complex point;
-    int bits[BPS];
+    int bits[MAX_BPS];
 } Constellation;
 
+typedef struct {
+    int count;
+    int index[LABEL_NEIGHBOURS];        // Vecinos del más cercano al más lejano
+    int weight[LABEL_NEIGHBOURS];
+    double minimum_distance2;           // Distancia^2 al punto más cercano
+} LabelNeighbours;
+
+typedef struct {
+    int bits_per_symbol;
+    int num_points;                     // 2^bits_per_symbol
+    int symbols_per_block;              // Símbolos por bloque de transporte (último símbolo relleno con ceros)
+    Constellation points[MAX_C_POINTS]; // Punto y bits por índice de la espiral
+    float point_re[MAX_C_POINTS];       // Coordenadas separadas para el demapeador suave
+    float point_im[MAX_C_POINTS];
+    float complex label_to_point[MAX_C_POINTS];  // Tabla inversa: etiqueta empaquetada (primer bit = MSB) -> punto
+    int label_of_index[MAX_C_POINTS];
+    int index_of_label[MAX_C_POINTS];
+
+    // Rejilla de decisión: índice decidido o lista corta de candidatos por celda (0 = exhaustiva)
+    float grid_origin;                  // Esquina inferior izquierda (misma en I y Q)
+    float grid_inverse_cell;            // 1 / tamaño de celda
+    uint8_t grid_count[DECISION_GRID_SIZE * DECISION_GRID_SIZE];
+    uint16_t grid_candidates[DECISION_GRID_SIZE * DECISION_GRID_SIZE][DECISION_GRID_MAX_CANDIDATES];
+
+    // Índice espacial polar: el radio crece con el índice de la espiral, así que anillos de grosor fijo
+    // agrupan índices consecutivos; cada anillo se divide en sectores de arco ~ grosor (celdas casi cuadradas)
+    bool use_spatial_index;
+    int spatial_rings;
+    float spatial_ring_width;
+    float spatial_inverse_ring_width;
+    int ring_sectors[SPATIAL_MAX_RINGS];
+    int ring_first_cell[SPATIAL_MAX_RINGS + 1];
+    float sector_cos[SPATIAL_MAX_CELLS];        // cos/sin de d anchos de sector, d = 0.. (por anillo)
+    float sector_sin[SPATIAL_MAX_CELLS];
+    int cell_start[SPATIAL_MAX_CELLS + 1];      // Puntos de la celda c: [cell_start[c], cell_start[c + 1])
+    uint16_t cell_index[MAX_C_POINTS];          // Índice, etiqueta y coordenadas de los puntos en orden de celda
+    uint16_t cell_label[MAX_C_POINTS];
+    float cell_re[MAX_C_POINTS];
+    float cell_im[MAX_C_POINTS];
+    bool initialized;
+} GAMConstellation;
+
+typedef struct {
+    float y_re, y_im;
+    float radius, angle;                // Símbolo en polares (ángulo en [0, 2pi))
+    float bound;                        // Distancia^2 máxima de interés: celdas con cota inferior mayor se saltan
+    bool nearest;                       // true: punto más cercano (cota = su distancia); false: acumula LLR
+    int best_index;
+    float reference;                    // Modo LLR: menor distancia^2 vista (cota = reference + margin)
+    float margin;
+    float inverse_variance;
+    bool exact;
+    int bits_per_symbol;
+    float minimum[2][MAX_BPS];          // [bit][k]: menor distancia^2 entre los puntos con el bit k = bit
+    float sum[2][MAX_BPS];              // [bit][k]: suma de exp(-(d - reference) / sigma^2) (modo exacto)
+} SpatialQuery;
+
+typedef struct {
+    uint64_t state[4];                          // xoshiro256++ (periodo 2^256 - 1)
+    uint32_t ziggurat_k[ZIGGURAT_LAYERS];       // Umbral de aceptación directa por capa
+    float ziggurat_w[ZIGGURAT_LAYERS];          // Escala entero -> x por capa
+    float ziggurat_f[ZIGGURAT_LAYERS];          // exp(-x^2 / 2) en el borde de cada capa
+    bool initialized;
+} RngState;
+
+typedef enum {
+    RNG_STAGE_DATA,                     // Bits de datos (un subflujo por bloque de transporte)
+    RNG_STAGE_NOISE,                    // Ruido AWGN del canal
+    RNG_STAGE_BURST,                    // Decisión, posición y ruido de las ráfagas
+    RNG_STAGE_FADING,                   // Fases y ángulos de llegada del canal TDL
+    RNG_STAGE_PHASE_NOISE,              // Incrementos del ruido de fase de Wiener
+    RNG_STAGE_CFAR_NOISE                // Ruido sin señal para medir la Pfa del CFAR
+} RngStage;
+
 typedef struct {
     int data_bits[TB_SIZE_BITS];
     int crc_bits[CRC_TYPE];
@@ -126,5 +292,279 @@ typedef struct {
     int symbol_count;
 } SCOTracker;
 
+typedef struct {
+    int size;
+    int log2_size;
+    float complex *twiddles;   // e^(-j2πk/N), k = 0..N/2-1
+    int *bit_reverse;
+    bool initialized;
+} FFTPlan;
+
+typedef struct {
+    int size;                  // N
+    int band_start;            // k0: primer bin ocupado
+    int band_len;              // L: bins ocupados contiguos
+    int sub_size;              // M: potencia de 2 >= L
+    int decimation;            // D = N / M sub-FFTs
+    FFTPlan sub_plan;          // Plan de M puntos
+    float complex *twiddles;   // e^(-j2π(k0+m)r/N), [r][m], r < D, m < L
+    bool initialized;
+} PrunedFFTPlan;
+
+typedef struct {
+    float complex *frame;      // Buffer final: preámbulo + num_prbs x PRB_SYMBOLS x (CP + N_FFT)
+    int length;
+    int num_prbs;              // PRBs tras el preámbulo (1 = trama simple, > 1 = supertrama)
+    int symbols_committed;
+    bool initialized;
+} FrameBuilder;
+
+typedef struct {
+    float reference_re[PREAMBLE_LEN];   // conj(preámbulo) precalculado una sola vez
+    float reference_im[PREAMBLE_LEN];
+    float reference_power;
+    double received_power;              // Potencia de la ventana actual (suma móvil)
+    int window_start;
+    bool initialized;
+} PreambleCorrelator;
+
+typedef struct {
+    int index;                          // Primera muestra del preámbulo en la captura
+    float metric;                       // Correlación normalizada del pico
+} PreamblePeak;
+
+typedef struct {
+    FFTPlan plan;                       // Bloques de B muestras (B >= 2 * PREAMBLE_LEN)
+    float complex *reference_spectrum;  // conj(FFT(preámbulo con ceros hasta B))
+    float complex *block;               // Espacio de trabajo de B muestras
+    float reference_power;
+    int block_size;
+    int step;                           // Desplazamientos válidos por bloque: B - PREAMBLE_LEN + 1
+    bool initialized;
+} OverlapSaveCorrelator;
+
+typedef enum {
+    TDL_EPA,                            // Extended Pedestrian A (410 ns)
+    TDL_EVA,                            // Extended Vehicular A (2510 ns)
+    TDL_ETU                             // Extended Typical Urban (5000 ns)
+} TDLProfile;
+
+typedef struct {
+    int num_taps;
+    int delay[TDL_MAX_TAPS];            // Retardo de cada trayecto (muestras)
+    float amplitude[TDL_MAX_TAPS];      // Amplitud media de la parte difusa
+    float los_amplitude;                // Componente directa del primer trayecto (Rician)
+    int max_delay;
+    float doppler_hz;
+
+    // Suma de sinusoides: fasor actual y rotación por intervalo de actualización
+    float phasor_re[TDL_MAX_TAPS][TDL_SINUSOIDS];
+    float phasor_im[TDL_MAX_TAPS][TDL_SINUSOIDS];
+    float rotation_re[TDL_MAX_TAPS][TDL_SINUSOIDS];
+    float rotation_im[TDL_MAX_TAPS][TDL_SINUSOIDS];
+    float complex los_phasor;
+    float complex los_rotation;
+
+    // Convolución por bloques (ganancias congeladas en el centro de cada bloque)
+    bool use_overlap_save;
+    FFTPlan plan;
+    int fft_size;
+    int fft_step;                       // Muestras nuevas por bloque: fft_size - max_delay
+    float complex *fft_block;
+    float complex *fft_response;
+    bool initialized;
+} TDLChannel;
+
+typedef struct {
+    // NCO: acumulador de fase entero (vuelta completa = 2^32, sin deriva en ejecuciones largas)
+    uint32_t nco_phase;
+    uint32_t nco_step;
+    uint32_t phase_noise;               // Fase acumulada del ruido de fase (mismas unidades que el NCO)
+    float phase_noise_std;              // Desviación del incremento de Wiener por muestra (unidades NCO)
+    float phase_increments[RF_IMPAIRMENT_BLOCK];
+    int next_increment;                 // Incrementos ya usados del lote actual
+    float complex nco_table[(1 << RF_NCO_TABLE_BITS) + 1];  // e^(j·2π·k / 2^bits)
+
+    // Remuestreador Farrow (Lagrange cúbico): 4 muestras de historia, memoria O(1)
+    double resample_step;               // Avance en muestras de entrada por muestra de salida: 1 + ppm·1e-6
+    double mu;                          // Posición fraccionaria entre history[1] e history[2]
+    float complex history[4];
+    int history_count;
+    int pending_shifts;                 // Muestras de entrada que faltan por consumir antes de la siguiente salida
+
+    float cfo_hz;
+    float linewidth_hz;
+    float sco_ppm;
+    long long samples_in;
+    long long samples_out;
+    bool initialized;
+} RFImpairments;
+
+typedef enum {
+    ABSTRACT_AWGN,                      // Ruido blanco sobre los símbolos de datos
+    ABSTRACT_GILBERT_ELLIOTT            // Cadena de Markov bueno/malo (ráfagas) sobre los símbolos
+} AbstractChannelModel;
+
+typedef struct {
+    AbstractChannelModel model;
+    float snr_db;                       // SNR temporal equivalente a la cadena completa
+    float symbol_snr_db;                // SNR por RE de datos (snr_db + diferencia medida en la supertrama)
+    float bad_snr_db;                   // SNR por RE en el estado malo (Gilbert-Elliott)
+    float p_good_to_bad;
+    float p_bad_to_good;
+    bool bad_state;
+    uint64_t seed;
+    RngState rng;
+    long long symbols;
+    long long bad_symbols;
+    bool initialized;
+} AbstractChannel;
+
+typedef struct {
+    int preamble_index;                 // Primera muestra del preámbulo
+    int frame_start;                    // Primera muestra tras el preámbulo
+    float metric;                       // |P|^2 / (E1 E2) en el pico
+    float cfo;                          // CFO grueso en rad/muestra
+    float cfo_std;                      // Desviación típica estimada del CFO (rad/muestra)
+} SchmidlCoxResult;
+
+typedef struct {
+    FFTPlan plan;                       // FFT de CFO_BANK_FFT_SIZE puntos sobre r[d + n] conj(p[n])
+    float reference_re[PREAMBLE_LEN];   // Preámbulo conjugado
+    float reference_im[PREAMBLE_LEN];
+    float reference_power;
+    float *batch_re;                    // Lote CFO_BANK_BATCH x CFO_BANK_FFT_SIZE en formato [n * batch + b]
+    float *batch_im;
+    int max_bin;                        // Hipótesis evaluadas: bins [-max_bin, max_bin]
+    bool initialized;
+} CFOBankDetector;
+
+typedef struct {
+    int preamble_index;                 // Primera muestra del preámbulo
+    int frame_start;                    // Primera muestra tras el preámbulo
+    int hypothesis;                     // Bin ganador del banco
+    float metric;                       // Correlación normalizada con la hipótesis ganadora
+    float cfo;                          // CFO interpolado entre bins (rad/muestra)
+} CFOBankResult;
+
+typedef enum {
+    CFAR_CELL_AVERAGING,                // Media de las celdas de referencia (sumas móviles, O(1))
+    CFAR_ORDER_STATISTIC                // k-ésimo valor ordenado (robusto frente a picos vecinos)
+} CFARMode;
+
+typedef struct {
+    CFARMode mode;
+    double false_alarm_rate;
+    float scale[2 * CFAR_REFERENCE_CELLS + 1];  // Factor de umbral según las celdas de referencia disponibles
+    int rank[2 * CFAR_REFERENCE_CELLS + 1];     // Orden k (solo OS-CFAR)
+    long long searches;                 // Búsquedas realizadas
+    long long frames_detected;          // Búsquedas con preámbulo detectado
+    long long cells_tested;
+    long long cells_above;              // Celdas por encima del umbral
+    long long noise_searches;           // Búsquedas sobre solo ruido (medida de la Pfa)
+    long long noise_cells;
+    long long false_alarms;             // Celdas de solo ruido por encima del umbral
+    double noise_floor_sum;             // Suma del suelo estimado (media por celda)
+    float last_noise_floor;
+    float last_threshold;
+    bool initialized;
+} CFARDetector;
+
+typedef enum {
+    ENERGY_GATE_NONE,                   // Sin cambio de estado
+    ENERGY_GATE_OPEN,                   // Empieza un segmento activo (segment_start válido)
+    ENERGY_GATE_CLOSE                   // Termina el segmento activo (segment_end válido)
+} EnergyGateEvent;
+
+typedef struct {
+    long long start;                    // Primera muestra (margen incluido)
+    long long end;                      // Una más que la última muestra (margen incluido)
+} ActiveSegment;
+
+typedef struct {
+    float power_history[ENERGY_WINDOW]; // |x|^2 de las últimas ENERGY_WINDOW muestras
+    double window_power;                // Suma móvil de la ventana
+    int history_position;
+    int history_count;
+    double noise_floor;                 // Potencia media estimada en reposo
+    float on_ratio;                     // Umbrales lineales relativos al suelo
+    float off_ratio;
+    int guard_samples;
+    int quiet_samples;                  // Muestras seguidas bajo el umbral de cierre
+    bool active;
+    long long sample_index;             // Índice absoluto de la siguiente muestra
+    long long segment_start;
+    long long segment_end;
+    long long active_samples;
+    bool initialized;
+} EnergyDetector;
+
+typedef struct {
+    CFOResidualTracker cfo_tracker;
+    CPETracker cpe_tracker;
+    SCOTracker sco_tracker;
+    float complex previous_pilots[PRB_SYMBOLS][PILOTS_PER_SYMBOL];
+    bool first_frame;
+} ReceiverState;
+
+typedef void (*TransportBlockCallback)(const TransportBlock *tb, long long frame_start_sample, int block_index,
+                                       void *user_data);
+
+typedef struct {
+    float complex *ring;                // 2 x capacity: cada muestra se escribe dos veces (ventanas contiguas)
+    int capacity;                       // Potencia de 2 >= 2 supertramas
+    long long write_count;              // Índice absoluto de la siguiente muestra
+    long long search_position;          // Primer desplazamiento aún no correlado
+    long long candidate_index;          // Pico de preámbulo pendiente de confirmar (-1 si no hay)
+    float candidate_metric;
+    long long pending_frame_start;      // Supertrama detectada esperando muestras (-1 si no hay)
+    PreambleCorrelator correlator;
+    ReceiverState rx_state;
+    const GAMConstellation *constellation;  // Orden de modulación del flujo (caché compartida por orden)
+    TransportBlockCallback on_block;
+    void *user_data;
+    int frames_decoded;
+    int frames_crc_valid;
+    EnergyDetector gate;                // Compuerta de energía: solo se correla dentro de segmentos activos
+    bool gating_enabled;
+    long long gate_start;               // Inicio (con margen) del último segmento abierto
+    long long gate_end;                 // Fin del último segmento cerrado
+    long long samples_skipped;          // Desplazamientos no correlados por estar en reposo
+    bool initialized;
+} StreamReceiver;
+
+typedef struct {
+    TransportBlock tb;
+    long long frame_start;              // Primera muestra tras el preámbulo en la captura
+    int block_index;                    // PRB dentro de la supertrama
+} DecodedBlock;
+
+typedef struct {
+    const float complex *capture;
+    long long start;                    // Primera muestra del trozo
+    long long core_end;                 // Preámbulos que empiezan antes pertenecen a este trozo
+    long long end;                      // core_end + una trama de solape (recortado a la captura)
+    DecodedBlock *blocks;               // Bloques propios en orden de llegada
+    int num_blocks;
+    int capacity;
+    bool error;
+} CaptureChunk;
+
+typedef struct {
+    CaptureChunk *chunks;
+    LONG num_chunks;
+    volatile LONG next_chunk;           // Siguiente trozo libre (InterlockedIncrement)
+} CaptureJob;
+
+typedef struct {
+    const int *tx_bits;                 // Bits de datos enviados [trama][PRB][bit]
+    int num_frames;
+    long long first_preamble;           // Muestra del primer preámbulo de la captura
+    long long frame_period;             // Muestras entre preámbulos consecutivos
+    int blocks_received;
+    int blocks_correct;                 // CRC válido y bits idénticos a los enviados
+    int blocks_misplaced;               // Posición fuera de la rejilla de supertramas
+} CaptureCheck;
+
 
 #endif //GAM_COMMON_H
@@ -1,14 +1,43 @@
 #include "Datasource.h"
+#include "../RNG/Rng.h"
+
+// Generador por defecto (flujo secuencial, no reentrante)
+static RngState datasource_rng;
 
 // FUNCIONES DATASOURCE
-bool generate_random_bits(int bits[TB_SIZE_BITS])
+bool generate_random_bits_stream(RngState *rng, int bits[TB_SIZE_BITS])
 {
-    for (int i = 0; i < TB_SIZE_BITS; i++)
-    {   bits[i] = rand() % 2;   }
+    if (!rng)
+    {
+        printf("Error: Generador aleatorio no valido\n");
+        return true;
+    }
+
+    // 64 bits de datos por cada salida del generador
+    for (int i = 0; i < TB_SIZE_BITS; i += 64)
+    {
+        uint64_t word = rng_next_u64(rng);
+        for (int j = 0; j < 64 && i + j < TB_SIZE_BITS; j++)
+        {   bits[i + j] = (int)((word >> j) & 1);   }
+    }
 
     return false;
 }
 
+bool generate_random_bits(int bits[TB_SIZE_BITS])
+{
+    if (!datasource_rng.initialized) set_rng_stream(&datasource_rng, SIMULATION_SEED, 0, RNG_STAGE_DATA, 0);
+
+    return generate_random_bits_stream(&datasource_rng, bits);
+}
+
+bool generate_frame_bits(uint64_t seed, long long frame, int block, RngState *rng, int bits[TB_SIZE_BITS])
+{
+    if (set_rng_stream(rng, seed, (uint64_t)frame, RNG_STAGE_DATA, (uint32_t)block)) return true;
+
+    return generate_random_bits_stream(rng, bits);
+}
+
 float calculate_ber(const int tx_bits[TB_SIZE_BITS], const int rx_bits[TB_SIZE_BITS])
 {
     int errors = 0;
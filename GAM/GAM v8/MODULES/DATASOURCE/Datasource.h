@@ -7,6 +7,11 @@
 // GENERACIÓN DE BITS Y CÁLCULO DE ERRORES
 bool generate_random_bits(int bits[TB_SIZE_BITS]);
 
+bool generate_random_bits_stream(RngState *rng, int bits[TB_SIZE_BITS]);
+
+// Bits del bloque 'block' de la trama 'frame': idénticos en cualquier hilo y orden de generación
+bool generate_frame_bits(uint64_t seed, long long frame, int block, RngState *rng, int bits[TB_SIZE_BITS]);
+
 float calculate_ber(const int tx_bits[TB_SIZE_BITS], const int rx_bits[TB_SIZE_BITS]);
 
 float calculate_bler(int successful_transmissions, int total_transmissions);
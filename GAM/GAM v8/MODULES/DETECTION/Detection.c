@@ -0,0 +1,459 @@
+#include "Detection.h"
+#include "../FRAME/Frame.h"
+
+// FUNCIONES CFAR
+// Factor α del OS-CFAR: Pfa = prod_{i<k} (n - i) / (n - i + α), resuelto por bisección
+static float os_cfar_scale(int n, int k, double false_alarm_rate)
+{
+    double target = log(false_alarm_rate);
+    double low = 0.0, high = 1.0;
+
+    while (high < 1e9)
+    {
+        double log_pfa = 0.0;
+        for (int i = 0; i < k; i++) { log_pfa += log((double)(n - i) / (double)(n - i + high)); }
+        if (log_pfa < target) break;
+        high *= 2.0;
+    }
+
+    for (int iter = 0; iter < 60; iter++)
+    {
+        double mid = 0.5 * (low + high);
+        double log_pfa = 0.0;
+        for (int i = 0; i < k; i++) { log_pfa += log((double)(n - i) / (double)(n - i + mid)); }
+
+        if (log_pfa > target) low = mid;
+        else high = mid;
+    }
+
+    return (float)high;
+}
+
+bool init_cfar_detector(CFARDetector *cfar, CFARMode mode, double false_alarm_rate)
+{
+    if (!cfar || false_alarm_rate <= 0.0 || false_alarm_rate >= 1.0)
+    {
+        printf("Error: Parametros CFAR no validos (Pfa=%g)\n", false_alarm_rate);
+        return true;
+    }
+
+    cfar->mode = mode;
+    cfar->false_alarm_rate = false_alarm_rate;
+
+    // Umbral para n celdas de referencia disponibles (menos en los bordes de la captura)
+    cfar->scale[0] = 0.0f;
+    cfar->rank[0] = 0;
+    for (int n = 1; n <= 2 * CFAR_REFERENCE_CELLS; n++)
+    {
+        if (mode == CFAR_CELL_AVERAGING)
+        {
+            // CA-CFAR con celdas exponenciales: umbral = (Pfa^(-1/n) - 1) * suma
+            cfar->scale[n] = (float)(pow(false_alarm_rate, -1.0 / n) - 1.0);
+            cfar->rank[n] = 0;
+        }
+        else
+        {
+            int k = (int)ceil(CFAR_OS_RANK * n);
+            if (k < 1) k = 1;
+            if (k > n) k = n;
+            cfar->rank[n] = k;
+            cfar->scale[n] = os_cfar_scale(n, k, false_alarm_rate);
+        }
+    }
+
+    cfar->searches = 0;
+    cfar->frames_detected = 0;
+    cfar->cells_tested = 0;
+    cfar->cells_above = 0;
+    cfar->noise_searches = 0;
+    cfar->noise_cells = 0;
+    cfar->false_alarms = 0;
+    cfar->noise_floor_sum = 0.0;
+    cfar->last_noise_floor = 0.0f;
+    cfar->last_threshold = 0.0f;
+    cfar->initialized = true;
+
+    return false;
+}
+
+// k-ésimo menor (k desde 0) por selección parcial, reordena values
+static float select_kth(float values[], int n, int k)
+{
+    int left = 0, right = n - 1;
+
+    while (left < right)
+    {
+        float pivot = values[(left + right) / 2];
+        int i = left, j = right;
+
+        while (i <= j)
+        {
+            while (values[i] < pivot) i++;
+            while (values[j] > pivot) j--;
+            if (i <= j)
+            {
+                float tmp = values[i];
+                values[i] = values[j];
+                values[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+
+        if (k <= j) right = j;
+        else if (k >= i) left = i;
+        else break;
+    }
+
+    return values[k];
+}
+
+// Umbral de la celda d con las celdas [0, count) disponibles (prefix: sumas acumuladas de cell);
+// FLT_MAX si no hay celdas de referencia
+static float cfar_cell_threshold(const CFARDetector *cfar, const float cell[], const double prefix[], int count,
+                                 int d, float *noise_floor)
+{
+    // Ventana de referencia a ambos lados, separada por las celdas de guarda
+    int left_end = d - CFAR_GUARD_CELLS;                       // exclusivo
+    int left_start = left_end - CFAR_REFERENCE_CELLS;
+    int right_start = d + CFAR_GUARD_CELLS + 1;
+    int right_end = right_start + CFAR_REFERENCE_CELLS;        // exclusivo
+    if (left_start < 0) left_start = 0;
+    if (left_end < 0) left_end = 0;
+    if (right_start > count) right_start = count;
+    if (right_end > count) right_end = count;
+
+    int n = (left_end - left_start) + (right_end - right_start);
+    if (n == 0) return FLT_MAX;
+
+    double reference_sum = (prefix[left_end] - prefix[left_start]) + (prefix[right_end] - prefix[right_start]);
+    *noise_floor = (float)(reference_sum / n);
+
+    if (cfar->mode == CFAR_CELL_AVERAGING) return cfar->scale[n] * (float)reference_sum;
+
+    float reference[2 * CFAR_REFERENCE_CELLS];
+    int filled = 0;
+    for (int i = left_start; i < left_end; i++) reference[filled++] = cell[i];
+    for (int i = right_start; i < right_end; i++) reference[filled++] = cell[i];
+    return cfar->scale[n] * select_kth(reference, n, cfar->rank[n] - 1);
+}
+
+// Celdas |correlación normalizada|^2 de los desplazamientos [start, end) y sus sumas acumuladas
+static void cfar_fill_cells(PreambleCorrelator *correlator, const float complex received_signal[], int length,
+                            int start, int end, float cell[], double prefix[])
+{
+    reset_preamble_correlator(correlator, received_signal, start);
+
+    prefix[0] = 0.0;
+    for (int d = 0; d < end - start; d++)
+    {
+        float metric = preamble_correlator_next(correlator, received_signal, length);
+        cell[d] = metric * metric;
+        prefix[d + 1] = prefix[d] + cell[d];
+    }
+}
+
+// Dos etapas: la correlación de signos elige COARSE_CANDIDATES desplazamientos y solo esos (±1) pasan el test
+// CFAR; cada umbral usa las mismas celdas de referencia que una búsqueda completa
+bool detect_frame_start_cfar(CFARDetector *cfar, const float complex received_signal[], int length,
+                             int *frame_start_index)
+{
+    if (!cfar || !cfar->initialized || !frame_start_index)
+    {
+        printf("Error: Detector CFAR no inicializado\n");
+        return true;
+    }
+
+    int offsets = length - PREAMBLE_LEN + 1;
+    int candidate_index[COARSE_CANDIDATES];
+    int num_candidates;
+    if (find_coarse_preamble_candidates(received_signal, length, candidate_index, &num_candidates)) return true;
+
+    PreambleCorrelator correlator;
+    if (init_preamble_correlator(&correlator)) return true;
+
+    // En orden de índice, para no evaluar dos veces las celdas compartidas por candidatos vecinos
+    for (int c = 1; c < num_candidates; c++)
+    {
+        int index = candidate_index[c], pos = c;
+        for (; pos > 0 && candidate_index[pos - 1] > index; pos--) candidate_index[pos] = candidate_index[pos - 1];
+        candidate_index[pos] = index;
+    }
+
+    const int reach = 1 + CFAR_GUARD_CELLS + CFAR_REFERENCE_CELLS;
+    float cell[2 * reach + 1];
+    double prefix[2 * reach + 2];
+    int best_index = -1, last_tested = -1;
+    float best_cell = 0.0f, best_ratio = 0.0f, best_peak_ratio = 0.0f;
+
+    for (int c = 0; c < num_candidates; c++)
+    {
+        int start = candidate_index[c] - reach, end = candidate_index[c] + reach + 1;   // end exclusivo
+        if (start < 0) start = 0;
+        if (end > offsets) end = offsets;
+        cfar_fill_cells(&correlator, received_signal, length, start, end, cell, prefix);
+
+        for (int d = candidate_index[c] - 1; d <= candidate_index[c] + 1; d++)
+        {
+            if (d < 0 || d >= offsets || d <= last_tested) continue;
+            last_tested = d;
+
+            float noise_floor;
+            float threshold = cfar_cell_threshold(cfar, cell, prefix, end - start, d - start, &noise_floor);
+            if (threshold == FLT_MAX) continue;
+
+            float value = cell[d - start];
+            cfar->cells_tested++;
+            cfar->noise_floor_sum += noise_floor;
+            if (value > threshold) cfar->cells_above++;
+
+            float ratio = (threshold > 0.0f) ? value / threshold : 0.0f;
+            if (ratio > best_peak_ratio) best_peak_ratio = ratio;
+
+            // Entre las celdas que superan el umbral se elige la de mayor correlación
+            if (value > threshold && (best_index < 0 || value > best_cell))
+            {
+                best_index = d;
+                best_cell = value;
+                best_ratio = ratio;
+                cfar->last_noise_floor = noise_floor;
+                cfar->last_threshold = threshold;
+            }
+        }
+    }
+
+    cfar->searches++;
+
+    bool detected = (best_index >= 0);
+    if (detected)
+    {
+        cfar->frames_detected++;
+        *frame_start_index = best_index + PREAMBLE_LEN;
+        printf("CFAR: preambulo en indice %d (|c|^2 %.4f, umbral %.4f, suelo %.5f, margen %.1f dB, %d candidatos)\n",
+               best_index, best_cell, cfar->last_threshold, cfar->last_noise_floor, 10.0f * log10f(best_ratio),
+               num_candidates);
+    }
+    else
+    {
+        printf("CFAR: preambulo NO detectado (mejor |c|^2 / umbral: %.3f)\n", best_peak_ratio);
+    }
+
+    return !detected;
+}
+
+// Sin señal toda celda sobre el umbral es una falsa alarma: se prueban todas, no solo los candidatos, para
+// medir la Pfa por celda del umbral (con señal, las celdas sobre el umbral incluyen lóbulos del preámbulo)
+bool measure_cfar_false_alarms(CFARDetector *cfar, const float complex noise[], int length)
+{
+    if (!cfar || !cfar->initialized)
+    {
+        printf("Error: Detector CFAR no inicializado\n");
+        return true;
+    }
+
+    int offsets = length - PREAMBLE_LEN + 1;
+    if (offsets <= 0)
+    {
+        printf("Error: Ventana de busqueda insuficiente (%d)\n", offsets);
+        return true;
+    }
+
+    float *cell = malloc((size_t)offsets * sizeof(float));
+    double *prefix = malloc((size_t)(offsets + 1) * sizeof(double));
+    PreambleCorrelator correlator;
+    if (!cell || !prefix || init_preamble_correlator(&correlator))
+    {
+        printf("Error: Sin memoria para detector CFAR\n");
+        free(cell);
+        free(prefix);
+        return true;
+    }
+
+    cfar_fill_cells(&correlator, noise, length, 0, offsets, cell, prefix);
+
+    cfar->noise_searches++;
+    cfar->noise_cells += offsets;
+    for (int d = 0; d < offsets; d++)
+    {
+        float noise_floor;
+        if (cell[d] > cfar_cell_threshold(cfar, cell, prefix, offsets, d, &noise_floor)) cfar->false_alarms++;
+    }
+
+    free(cell);
+    free(prefix);
+
+    return false;
+}
+
+void print_cfar_statistics(const CFARDetector *cfar)
+{
+    if (!cfar || !cfar->initialized) return;
+
+    double false_alarm_rate = (cfar->noise_cells > 0) ? (double)cfar->false_alarms / (double)cfar->noise_cells : 0.0;
+    double false_alarms_per_search = (cfar->noise_searches > 0) ?
+                                     (double)cfar->false_alarms / (double)cfar->noise_searches : 0.0;
+    double noise_floor = (cfar->cells_tested > 0) ? cfar->noise_floor_sum / (double)cfar->cells_tested : 0.0;
+
+    printf("\n=== ESTADISTICAS CFAR (%s) ===\n",
+           cfar->mode == CFAR_CELL_AVERAGING ? "CA" : "OS");
+    printf("Busquedas: %lld | Preambulos detectados: %lld\n", cfar->searches, cfar->frames_detected);
+    printf("Celdas evaluadas: %lld | Sobre umbral: %lld\n", cfar->cells_tested, cfar->cells_above);
+    printf("Busquedas sobre solo ruido: %lld | Celdas: %lld | Falsas alarmas: %lld\n",
+           cfar->noise_searches, cfar->noise_cells, cfar->false_alarms);
+    printf("Pfa objetivo: %.1e | Pfa medida: %.1e | Falsas alarmas por busqueda: %.3f\n",
+           cfar->false_alarm_rate, false_alarm_rate, false_alarms_per_search);
+    printf("Suelo medio de correlacion |c|^2: %.5f\n", noise_floor);
+}
+
+
+// FUNCIONES DETECCIÓN DE ENERGÍA
+bool init_energy_detector(EnergyDetector *detector, float on_db, float off_db, int guard_samples)
+{
+    if (!detector || off_db > on_db || guard_samples < 0)
+    {
+        printf("Error: Parametros de deteccion de energia no validos (on=%.1f dB, off=%.1f dB)\n", on_db, off_db);
+        return true;
+    }
+
+    for (int i = 0; i < ENERGY_WINDOW; i++) { detector->power_history[i] = 0.0f; }
+    detector->window_power = 0.0;
+    detector->history_position = 0;
+    detector->history_count = 0;
+    detector->noise_floor = 0.0;
+    detector->on_ratio = powf(10.0f, on_db / 10.0f);
+    detector->off_ratio = powf(10.0f, off_db / 10.0f);
+    detector->guard_samples = guard_samples;
+    detector->quiet_samples = 0;
+
+    // Se arranca activo: si la captura empieza con señal no se pierde la primera trama
+    detector->active = true;
+    detector->sample_index = 0;
+    detector->segment_start = 0;
+    detector->segment_end = 0;
+    detector->active_samples = 0;
+    detector->initialized = true;
+
+    return false;
+}
+
+EnergyGateEvent energy_detector_update(EnergyDetector *detector, float complex sample)
+{
+    EnergyGateEvent event = ENERGY_GATE_NONE;
+    long long index = detector->sample_index++;
+
+    // Media móvil de potencia en O(1)
+    float power = crealf(sample) * crealf(sample) + cimagf(sample) * cimagf(sample);
+    detector->window_power += power - detector->power_history[detector->history_position];
+    if (detector->window_power < 0.0) detector->window_power = 0.0;
+    detector->power_history[detector->history_position] = power;
+    detector->history_position = (detector->history_position + 1) % ENERGY_WINDOW;
+
+    if (detector->history_count < ENERGY_WINDOW)
+    {
+        detector->history_count++;
+        if (detector->history_count < ENERGY_WINDOW)
+        {
+            if (detector->active) detector->active_samples++;
+            return event;
+        }
+        detector->noise_floor = detector->window_power / ENERGY_WINDOW;
+    }
+
+    double mean_power = detector->window_power / ENERGY_WINDOW;
+
+    // Suelo de ruido: media lenta en reposo; con señal presente solo puede bajar
+    if (!detector->active || mean_power < detector->noise_floor)
+    {
+        detector->noise_floor += ENERGY_FLOOR_ALPHA * (mean_power - detector->noise_floor);
+    }
+
+    if (detector->active)
+    {
+        // Cierre tras guard_samples seguidas bajo el umbral (los segmentos cercanos se fusionan)
+        if (mean_power < detector->noise_floor * detector->off_ratio) detector->quiet_samples++;
+        else detector->quiet_samples = 0;
+
+        if (detector->quiet_samples > detector->guard_samples)
+        {
+            detector->active = false;
+            detector->segment_end = index + 1;
+            event = ENERGY_GATE_CLOSE;
+        }
+    }
+    else if (mean_power > detector->noise_floor * detector->on_ratio)
+    {
+        // La media móvil llega con ENERGY_WINDOW muestras de retraso: el margen empieza antes
+        detector->active = true;
+        detector->quiet_samples = 0;
+        detector->segment_start = index + 1 - ENERGY_WINDOW - detector->guard_samples;
+        if (detector->segment_start < 0) detector->segment_start = 0;
+        event = ENERGY_GATE_OPEN;
+    }
+
+    if (detector->active) detector->active_samples++;
+
+    return event;
+}
+
+bool find_active_segments(EnergyDetector *detector, const float complex signal[], int length,
+                          ActiveSegment segments[], int max_segments, int *num_segments)
+{
+    if (!detector || !detector->initialized || !signal || !segments || !num_segments)
+    {
+        printf("Error: Detector de energia no inicializado\n");
+        return true;
+    }
+
+    *num_segments = 0;
+    int dropped = 0;
+    long long base = detector->sample_index;
+    long long open_start = detector->active ? detector->segment_start : -1;
+
+    for (int i = 0; i < length; i++)
+    {
+        EnergyGateEvent event = energy_detector_update(detector, signal[i]);
+
+        if (event == ENERGY_GATE_OPEN)
+        {
+            open_start = detector->segment_start;
+        }
+        else if (event == ENERGY_GATE_CLOSE)
+        {
+            if (*num_segments < max_segments)
+            {
+                segments[*num_segments].start = (open_start > base) ? open_start - base : 0;
+                segments[*num_segments].end = detector->segment_end - base;
+                (*num_segments)++;
+            }
+            else
+            {
+                dropped++;
+            }
+            open_start = -1;
+        }
+    }
+
+    // Segmento todavía abierto al final de la captura
+    if (detector->active)
+    {
+        if (*num_segments < max_segments)
+        {
+            segments[*num_segments].start = (open_start > base) ? open_start - base : 0;
+            segments[*num_segments].end = length;
+            (*num_segments)++;
+        }
+        else
+        {
+            dropped++;
+        }
+    }
+
+    // Los segmentos que no caben se pierden: se avisa en vez de devolver una lista incompleta en silencio
+    if (dropped > 0)
+    {
+        printf("Error: %d segmentos activos descartados (maximo %d)\n", dropped, max_segments);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,29 @@
+#ifndef GAM_DETECTION_H
+#define GAM_DETECTION_H
+
+#include "../../MODULES/Common.h"
+
+
+// UMBRAL ADAPTATIVO CFAR (CA / OS) SOBRE LA CORRELACIÓN DEL PREÁMBULO
+bool init_cfar_detector(CFARDetector *cfar, CFARMode mode, double false_alarm_rate);
+
+bool detect_frame_start_cfar(CFARDetector *cfar, const float complex received_signal[], int length,
+                             int *frame_start_index);
+
+// Búsqueda sobre una entrada sin señal: solo acumula falsas alarmas para medir la Pfa real del umbral
+bool measure_cfar_false_alarms(CFARDetector *cfar, const float complex noise[], int length);
+
+void print_cfar_statistics(const CFARDetector *cfar);
+
+
+// DETECCIÓN DE ENERGÍA (media móvil de potencia con histéresis y márgenes de guarda)
+bool init_energy_detector(EnergyDetector *detector, float on_db, float off_db, int guard_samples);
+
+EnergyGateEvent energy_detector_update(EnergyDetector *detector, float complex sample);
+
+// Devuelve true si hay más de max_segments segmentos (se rellenan los primeros max_segments)
+bool find_active_segments(EnergyDetector *detector, const float complex signal[], int length,
+                          ActiveSegment segments[], int max_segments, int *num_segments);
+
+
+#endif //GAM_DETECTION_H
@@ -0,0 +1,515 @@
+#include "FFT.h"
+#include "FFT_Kernels.h"
+
+// FUNCIONES PLAN FFT
+bool init_fft_plan(FFTPlan *plan, int size)
+{
+    if (!plan || size < 2 || (size & (size - 1)) != 0)
+    {
+        printf("Error: Tamano FFT no valido (%d), debe ser potencia de 2\n", size);
+        return true;
+    }
+
+    plan->size = size;
+    plan->log2_size = 0;
+    while ((1 << plan->log2_size) < size) { plan->log2_size++; }
+
+    plan->twiddles = malloc((size_t)(size / 2) * sizeof(float complex));
+    plan->bit_reverse = malloc((size_t)size * sizeof(int));
+
+    if (!plan->twiddles || !plan->bit_reverse)
+    {
+        printf("Error: Sin memoria para plan FFT de %d puntos\n", size);
+        free(plan->twiddles);
+        free(plan->bit_reverse);
+        plan->initialized = false;
+        return true;
+    }
+
+    // Twiddles calculados en doble precisión una única vez
+    for (int k = 0; k < size / 2; k++)
+    {
+        double angle = -2.0 * M_PI * k / size;
+        plan->twiddles[k] = (float)cos(angle) + (float)sin(angle) * I;
+    }
+
+    // Tabla de permutación bit-reverse
+    for (int i = 0; i < size; i++)
+    {
+        int reversed = 0;
+        for (int b = 0; b < plan->log2_size; b++)
+        {
+            reversed |= ((i >> b) & 1) << (plan->log2_size - 1 - b);
+        }
+        plan->bit_reverse[i] = reversed;
+    }
+
+    plan->initialized = true;
+
+    return false;
+}
+
+void free_fft_plan(FFTPlan *plan)
+{
+    if (!plan) return;
+
+    free(plan->twiddles);
+    free(plan->bit_reverse);
+    plan->twiddles = NULL;
+    plan->bit_reverse = NULL;
+    plan->initialized = false;
+}
+
+
+// FUNCIONES TRANSFORMADA
+static void fft_radix2(const FFTPlan *plan, const float complex in[], float complex out[], float sign)
+{
+    int n = plan->size;
+
+    // Reordenación bit-reverse (intercambio si la transformada es in-place)
+    if (in == out)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            int j = plan->bit_reverse[i];
+            if (j > i)
+            {
+                float complex tmp = out[i];
+                out[i] = out[j];
+                out[j] = tmp;
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < n; i++) { out[plan->bit_reverse[i]] = in[i]; }
+    }
+
+    // Etapas mariposa radix-2 (decimación en tiempo)
+    for (int len = 2; len <= n; len <<= 1)
+    {
+        int half = len >> 1;
+        int stride = n / len;
+
+        for (int start = 0; start < n; start += len)
+        {
+            for (int k = 0; k < half; k++)
+            {
+                float w_re = crealf(plan->twiddles[k * stride]);
+                float w_im = sign * cimagf(plan->twiddles[k * stride]);
+
+                float complex a = out[start + k];
+                float complex b = out[start + k + half];
+
+                float t_re = crealf(b) * w_re - cimagf(b) * w_im;
+                float t_im = crealf(b) * w_im + cimagf(b) * w_re;
+
+                out[start + k] = (crealf(a) + t_re) + (cimagf(a) + t_im) * I;
+                out[start + k + half] = (crealf(a) - t_re) + (cimagf(a) - t_im) * I;
+            }
+        }
+    }
+}
+
+bool fft_forward(const FFTPlan *plan, const float complex in[], float complex out[])
+{
+    if (!plan || !plan->initialized)
+    {
+        printf("Error: Plan FFT no inicializado\n");
+        return true;
+    }
+
+    fft_radix2(plan, in, out, 1.0f);
+
+    return false;
+}
+
+bool fft_inverse(const FFTPlan *plan, const float complex in[], float complex out[])
+{
+    if (!plan || !plan->initialized)
+    {
+        printf("Error: Plan FFT no inicializado\n");
+        return true;
+    }
+
+    // Twiddles conjugados: e^(+j2πk/N)
+    fft_radix2(plan, in, out, -1.0f);
+
+    return false;
+}
+
+
+// FUNCIONES FFT PODADA
+static int next_power_of_two(int value)
+{
+    int result = 1;
+    while (result < value) { result <<= 1; }
+    return result;
+}
+
+static int log2_int(int value)
+{
+    int result = 0;
+    while ((1 << result) < value) { result++; }
+    return result;
+}
+
+bool pruned_fft_is_beneficial(int size, int band_len)
+{
+    int sub_size = next_power_of_two(band_len);
+    if (band_len <= 0 || sub_size >= size) return false;
+
+    // Mariposas de las D sub-FFTs + combinación final frente a la FFT completa
+    int decimation = size / sub_size;
+    long pruned_ops = (long)(size / 2) * log2_int(sub_size) + (long)band_len * decimation;
+    long full_ops = (long)(size / 2) * log2_int(size);
+
+    return pruned_ops < full_ops;
+}
+
+bool init_pruned_fft_plan(PrunedFFTPlan *plan, int size, int band_start, int band_len)
+{
+    if (!plan || size < 2 || (size & (size - 1)) != 0 ||
+        band_len <= 0 || band_len > size || band_start < 0 || band_start >= size)
+    {
+        printf("Error: Parametros FFT podada no validos (N=%d, inicio=%d, L=%d)\n",
+               size, band_start, band_len);
+        return true;
+    }
+
+    plan->size = size;
+    plan->band_start = band_start;
+    plan->band_len = band_len;
+    plan->sub_size = next_power_of_two(band_len);
+    if (plan->sub_size < 2) plan->sub_size = 2;
+    plan->decimation = size / plan->sub_size;
+
+    if (init_fft_plan(&plan->sub_plan, plan->sub_size)) return true;
+
+    plan->twiddles = malloc((size_t)plan->decimation * band_len * sizeof(float complex));
+    if (!plan->twiddles)
+    {
+        printf("Error: Sin memoria para plan FFT podada\n");
+        free_fft_plan(&plan->sub_plan);
+        plan->initialized = false;
+        return true;
+    }
+
+    // Twiddles de recombinación: la rotación de banda k0 queda absorbida aquí
+    for (int r = 0; r < plan->decimation; r++)
+    {
+        for (int m = 0; m < band_len; m++)
+        {
+            long phase_index = ((long)(band_start + m) * r) % size;
+            double angle = -2.0 * M_PI * (double)phase_index / size;
+            plan->twiddles[r * band_len + m] = (float)cos(angle) + (float)sin(angle) * I;
+        }
+    }
+
+    plan->initialized = true;
+
+    return false;
+}
+
+void free_pruned_fft_plan(PrunedFFTPlan *plan)
+{
+    if (!plan) return;
+
+    free_fft_plan(&plan->sub_plan);
+    free(plan->twiddles);
+    plan->twiddles = NULL;
+    plan->initialized = false;
+}
+
+bool pruned_fft(const PrunedFFTPlan *plan, const float complex in[], float complex band[])
+{
+    if (!plan || !plan->initialized)
+    {
+        printf("Error: Plan FFT podada no inicializado\n");
+        return true;
+    }
+
+    int sub_size = plan->sub_size;
+    int decimation = plan->decimation;
+    int band_len = plan->band_len;
+    float complex sub[sub_size];
+
+    for (int m = 0; m < band_len; m++) { band[m] = 0.0f + 0.0f * I; }
+
+    // X[k0+m] = sum_r W_N^((k0+m)r) * FFT_M(x[sD+r])[(k0+m) mod M]
+    for (int r = 0; r < decimation; r++)
+    {
+        for (int s = 0; s < sub_size; s++) { sub[s] = in[s * decimation + r]; }
+
+        fft_radix2(&plan->sub_plan, sub, sub, 1.0f);
+
+        const float complex *tw = &plan->twiddles[r * band_len];
+        for (int m = 0; m < band_len; m++)
+        {
+            float complex y = sub[(plan->band_start + m) & (sub_size - 1)];
+            float w_re = crealf(tw[m]);
+            float w_im = cimagf(tw[m]);
+
+            band[m] += (crealf(y) * w_re - cimagf(y) * w_im) + (crealf(y) * w_im + cimagf(y) * w_re) * I;
+        }
+    }
+
+    return false;
+}
+
+bool pruned_ifft(const PrunedFFTPlan *plan, const float complex band[], float complex out[])
+{
+    if (!plan || !plan->initialized)
+    {
+        printf("Error: Plan FFT podada no inicializado\n");
+        return true;
+    }
+
+    int sub_size = plan->sub_size;
+    int decimation = plan->decimation;
+    int band_len = plan->band_len;
+    float complex sub[sub_size];
+
+    // x[sD+r] = IFFT_M(Z_r)[s], Z_r[(k0+m) mod M] = X[k0+m] * W_N^(-(k0+m)r)
+    for (int r = 0; r < decimation; r++)
+    {
+        for (int s = 0; s < sub_size; s++) { sub[s] = 0.0f + 0.0f * I; }
+
+        const float complex *tw = &plan->twiddles[r * band_len];
+        for (int m = 0; m < band_len; m++)
+        {
+            float w_re = crealf(tw[m]);
+            float w_im = -cimagf(tw[m]);
+
+            sub[(plan->band_start + m) & (sub_size - 1)] =
+                    (crealf(band[m]) * w_re - cimagf(band[m]) * w_im) +
+                    (crealf(band[m]) * w_im + cimagf(band[m]) * w_re) * I;
+        }
+
+        fft_radix2(&plan->sub_plan, sub, sub, -1.0f);
+
+        for (int s = 0; s < sub_size; s++) { out[s * decimation + r] = sub[s]; }
+    }
+
+    return false;
+}
+
+
+// NÚCLEOS ESCALARES (fallback portable)
+static void butterfly_scalar(float a_re[], float a_im[], float b_re[], float b_im[],
+                             float w_re, float w_im, int count)
+{
+    for (int b = 0; b < count; b++)
+    {
+        float t_re = b_re[b] * w_re - b_im[b] * w_im;
+        float t_im = b_re[b] * w_im + b_im[b] * w_re;
+
+        b_re[b] = a_re[b] - t_re;
+        b_im[b] = a_im[b] - t_im;
+        a_re[b] += t_re;
+        a_im[b] += t_im;
+    }
+}
+
+static void complex_mac_scalar(float acc_re[], float acc_im[], const float x_re[], const float x_im[],
+                               float w_re, float w_im, int count)
+{
+    for (int b = 0; b < count; b++)
+    {
+        acc_re[b] += x_re[b] * w_re - x_im[b] * w_im;
+        acc_im[b] += x_re[b] * w_im + x_im[b] * w_re;
+    }
+}
+
+static void complex_mul_scalar(float out_re[], float out_im[], const float x_re[], const float x_im[],
+                               float w_re, float w_im, int count)
+{
+    for (int b = 0; b < count; b++)
+    {
+        out_re[b] = x_re[b] * w_re - x_im[b] * w_im;
+        out_im[b] = x_re[b] * w_im + x_im[b] * w_re;
+    }
+}
+
+const FFTKernels fft_kernels_scalar = {
+        "Escalar",
+        butterfly_scalar,
+        complex_mac_scalar,
+        complex_mul_scalar
+};
+
+
+// SELECCIÓN DE NÚCLEOS SEGÚN CPUID
+static const FFTKernels *active_kernels = NULL;
+
+static const FFTKernels *select_fft_kernels(void)
+{
+    if (active_kernels) return active_kernels;
+
+    const FFTKernels *selected = &fft_kernels_scalar;
+
+#ifdef GAM_FFT_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        selected = &fft_kernels_avx512;
+    }
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        selected = &fft_kernels_avx2;
+    }
+#endif
+
+    active_kernels = selected;
+
+    return active_kernels;
+}
+
+const char *fft_kernels_name(void)
+{
+    return select_fft_kernels()->name;
+}
+
+
+// FUNCIONES FFT EN LOTE
+static void fft_batch_radix2(const FFTPlan *plan, float re[], float im[], int batch, float sign)
+{
+    const FFTKernels *kernels = select_fft_kernels();
+    int n = plan->size;
+
+    // Reordenación bit-reverse por filas completas del lote
+    for (int i = 0; i < n; i++)
+    {
+        int j = plan->bit_reverse[i];
+        if (j <= i) continue;
+
+        float *re_i = &re[i * batch], *re_j = &re[j * batch];
+        float *im_i = &im[i * batch], *im_j = &im[j * batch];
+        for (int b = 0; b < batch; b++)
+        {
+            float tmp_re = re_i[b], tmp_im = im_i[b];
+            re_i[b] = re_j[b]; im_i[b] = im_j[b];
+            re_j[b] = tmp_re;  im_j[b] = tmp_im;
+        }
+    }
+
+    // Mariposas: mismo twiddle para todo el lote
+    for (int len = 2; len <= n; len <<= 1)
+    {
+        int half = len >> 1;
+        int stride = n / len;
+
+        for (int start = 0; start < n; start += len)
+        {
+            for (int k = 0; k < half; k++)
+            {
+                float w_re = crealf(plan->twiddles[k * stride]);
+                float w_im = sign * cimagf(plan->twiddles[k * stride]);
+
+                kernels->butterfly(&re[(start + k) * batch], &im[(start + k) * batch],
+                                   &re[(start + k + half) * batch], &im[(start + k + half) * batch],
+                                   w_re, w_im, batch);
+            }
+        }
+    }
+}
+
+bool fft_batch_forward(const FFTPlan *plan, float re[], float im[], int batch)
+{
+    if (!plan || !plan->initialized || batch <= 0)
+    {
+        printf("Error: Plan FFT no inicializado o lote vacio\n");
+        return true;
+    }
+
+    fft_batch_radix2(plan, re, im, batch, 1.0f);
+
+    return false;
+}
+
+bool fft_batch_inverse(const FFTPlan *plan, float re[], float im[], int batch)
+{
+    if (!plan || !plan->initialized || batch <= 0)
+    {
+        printf("Error: Plan FFT no inicializado o lote vacio\n");
+        return true;
+    }
+
+    fft_batch_radix2(plan, re, im, batch, -1.0f);
+
+    return false;
+}
+
+bool pruned_fft_batch(const PrunedFFTPlan *plan, float re[], float im[], int batch,
+                      float band_re[], float band_im[])
+{
+    if (!plan || !plan->initialized || batch <= 0)
+    {
+        printf("Error: Plan FFT podada no inicializado o lote vacio\n");
+        return true;
+    }
+
+    const FFTKernels *kernels = select_fft_kernels();
+    int sub_size = plan->sub_size;
+    int decimation = plan->decimation;
+    int band_len = plan->band_len;
+
+    // x[sD+r] de cada lote ya está en [s][r][b]: D*batch sub-FFTs de M puntos en un solo paso
+    fft_batch_radix2(&plan->sub_plan, re, im, decimation * batch, 1.0f);
+
+    for (int m = 0; m < band_len; m++)
+    {
+        float *out_re = &band_re[m * batch], *out_im = &band_im[m * batch];
+        int row = (plan->band_start + m) & (sub_size - 1);
+
+        for (int b = 0; b < batch; b++) { out_re[b] = 0.0f; out_im[b] = 0.0f; }
+
+        for (int r = 0; r < decimation; r++)
+        {
+            kernels->complex_mac(out_re, out_im,
+                                 &re[(row * decimation + r) * batch], &im[(row * decimation + r) * batch],
+                                 crealf(plan->twiddles[r * band_len + m]),
+                                 cimagf(plan->twiddles[r * band_len + m]), batch);
+        }
+    }
+
+    return false;
+}
+
+bool pruned_ifft_batch(const PrunedFFTPlan *plan, const float band_re[], const float band_im[], int batch,
+                       float out_re[], float out_im[])
+{
+    if (!plan || !plan->initialized || batch <= 0)
+    {
+        printf("Error: Plan FFT podada no inicializado o lote vacio\n");
+        return true;
+    }
+
+    const FFTKernels *kernels = select_fft_kernels();
+    int sub_size = plan->sub_size;
+    int decimation = plan->decimation;
+    int band_len = plan->band_len;
+    int total = plan->size * batch;
+
+    for (int i = 0; i < total; i++) { out_re[i] = 0.0f; out_im[i] = 0.0f; }
+
+    // Z_r[(k0+m) mod M] = X[k0+m] * W_N^(-(k0+m)r), colocado en [j][r][b]
+    for (int m = 0; m < band_len; m++)
+    {
+        const float *in_re = &band_re[m * batch], *in_im = &band_im[m * batch];
+        int row = (plan->band_start + m) & (sub_size - 1);
+
+        for (int r = 0; r < decimation; r++)
+        {
+            kernels->complex_mul(&out_re[(row * decimation + r) * batch], &out_im[(row * decimation + r) * batch],
+                                 in_re, in_im,
+                                 crealf(plan->twiddles[r * band_len + m]),
+                                 -cimagf(plan->twiddles[r * band_len + m]), batch);
+        }
+    }
+
+    // La salida de las sub-IFFTs [s][r][b] coincide con el orden natural [n][b]
+    fft_batch_radix2(&plan->sub_plan, out_re, out_im, decimation * batch, -1.0f);
+
+    return false;
+}
@@ -0,0 +1,48 @@
+#ifndef GAM_FFT_H
+#define GAM_FFT_H
+
+#include "../../MODULES/Common.h"
+
+
+// PLANES FFT (tamaño potencia de 2)
+bool init_fft_plan(FFTPlan *plan, int size);
+
+void free_fft_plan(FFTPlan *plan);
+
+
+// TRANSFORMADAS (sin normalizar, admiten in == out)
+bool fft_forward(const FFTPlan *plan, const float complex in[], float complex out[]);
+
+bool fft_inverse(const FFTPlan *plan, const float complex in[], float complex out[]);
+
+
+// TRANSFORMADAS PODADAS (banda ocupada contigua de L bins)
+bool init_pruned_fft_plan(PrunedFFTPlan *plan, int size, int band_start, int band_len);
+
+void free_pruned_fft_plan(PrunedFFTPlan *plan);
+
+bool pruned_fft_is_beneficial(int size, int band_len);
+
+bool pruned_fft(const PrunedFFTPlan *plan, const float complex in[], float complex band[]);
+
+bool pruned_ifft(const PrunedFFTPlan *plan, const float complex band[], float complex out[]);
+
+
+// NÚCLEOS VECTORIALES (escalar / AVX2 / AVX-512, elegidos por CPUID al arrancar)
+const char *fft_kernels_name(void);
+
+
+// TRANSFORMADAS EN LOTE (formato separado re/im, muestra n del lote b en [n * batch + b])
+bool fft_batch_forward(const FFTPlan *plan, float re[], float im[], int batch);
+
+bool fft_batch_inverse(const FFTPlan *plan, float re[], float im[], int batch);
+
+// Usa re/im como memoria de trabajo: a la salida contienen las sub-FFTs, no la entrada
+bool pruned_fft_batch(const PrunedFFTPlan *plan, float re[], float im[], int batch,
+                      float band_re[], float band_im[]);
+
+bool pruned_ifft_batch(const PrunedFFTPlan *plan, const float band_re[], const float band_im[], int batch,
+                       float out_re[], float out_im[]);
+
+
+#endif //GAM_FFT_H
@@ -0,0 +1,96 @@
+#include "FFT_Kernels.h"
+
+// Compilado con -mavx2 -mfma; solo se usa si la CPU lo soporta (ver select_fft_kernels)
+#if defined(GAM_FFT_X86_KERNELS) && defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+static void butterfly_avx2(float a_re[], float a_im[], float b_re[], float b_im[],
+                           float w_re, float w_im, int count)
+{
+    __m256 wr = _mm256_set1_ps(w_re);
+    __m256 wi = _mm256_set1_ps(w_im);
+    int b = 0;
+
+    for (; b + 8 <= count; b += 8)
+    {
+        __m256 ar = _mm256_loadu_ps(&a_re[b]), ai = _mm256_loadu_ps(&a_im[b]);
+        __m256 br = _mm256_loadu_ps(&b_re[b]), bi = _mm256_loadu_ps(&b_im[b]);
+
+        __m256 tr = _mm256_fmsub_ps(br, wr, _mm256_mul_ps(bi, wi));
+        __m256 ti = _mm256_fmadd_ps(br, wi, _mm256_mul_ps(bi, wr));
+
+        _mm256_storeu_ps(&a_re[b], _mm256_add_ps(ar, tr));
+        _mm256_storeu_ps(&a_im[b], _mm256_add_ps(ai, ti));
+        _mm256_storeu_ps(&b_re[b], _mm256_sub_ps(ar, tr));
+        _mm256_storeu_ps(&b_im[b], _mm256_sub_ps(ai, ti));
+    }
+
+    // Carriles restantes
+    for (; b < count; b++)
+    {
+        float t_re = b_re[b] * w_re - b_im[b] * w_im;
+        float t_im = b_re[b] * w_im + b_im[b] * w_re;
+
+        b_re[b] = a_re[b] - t_re;
+        b_im[b] = a_im[b] - t_im;
+        a_re[b] += t_re;
+        a_im[b] += t_im;
+    }
+}
+
+static void complex_mac_avx2(float acc_re[], float acc_im[], const float x_re[], const float x_im[],
+                             float w_re, float w_im, int count)
+{
+    __m256 wr = _mm256_set1_ps(w_re);
+    __m256 wi = _mm256_set1_ps(w_im);
+    int b = 0;
+
+    for (; b + 8 <= count; b += 8)
+    {
+        __m256 xr = _mm256_loadu_ps(&x_re[b]), xi = _mm256_loadu_ps(&x_im[b]);
+        __m256 ar = _mm256_loadu_ps(&acc_re[b]), ai = _mm256_loadu_ps(&acc_im[b]);
+
+        ar = _mm256_fnmadd_ps(xi, wi, _mm256_fmadd_ps(xr, wr, ar));
+        ai = _mm256_fmadd_ps(xi, wr, _mm256_fmadd_ps(xr, wi, ai));
+
+        _mm256_storeu_ps(&acc_re[b], ar);
+        _mm256_storeu_ps(&acc_im[b], ai);
+    }
+
+    for (; b < count; b++)
+    {
+        acc_re[b] += x_re[b] * w_re - x_im[b] * w_im;
+        acc_im[b] += x_re[b] * w_im + x_im[b] * w_re;
+    }
+}
+
+static void complex_mul_avx2(float out_re[], float out_im[], const float x_re[], const float x_im[],
+                             float w_re, float w_im, int count)
+{
+    __m256 wr = _mm256_set1_ps(w_re);
+    __m256 wi = _mm256_set1_ps(w_im);
+    int b = 0;
+
+    for (; b + 8 <= count; b += 8)
+    {
+        __m256 xr = _mm256_loadu_ps(&x_re[b]), xi = _mm256_loadu_ps(&x_im[b]);
+
+        _mm256_storeu_ps(&out_re[b], _mm256_fmsub_ps(xr, wr, _mm256_mul_ps(xi, wi)));
+        _mm256_storeu_ps(&out_im[b], _mm256_fmadd_ps(xr, wi, _mm256_mul_ps(xi, wr)));
+    }
+
+    for (; b < count; b++)
+    {
+        out_re[b] = x_re[b] * w_re - x_im[b] * w_im;
+        out_im[b] = x_re[b] * w_im + x_im[b] * w_re;
+    }
+}
+
+const FFTKernels fft_kernels_avx2 = {
+        "AVX2+FMA",
+        butterfly_avx2,
+        complex_mac_avx2,
+        complex_mul_avx2
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "FFT_Kernels.h"
+
+// Compilado con -mavx512f; solo se usa si la CPU lo soporta (ver select_fft_kernels)
+#if defined(GAM_FFT_X86_KERNELS) && defined(__AVX512F__)
+#include <immintrin.h>
+
+// Máscara para los carriles restantes (< 16)
+static inline __mmask16 tail_mask(int remaining)
+{
+    return (__mmask16)((1u << remaining) - 1u);
+}
+
+static void butterfly_avx512(float a_re[], float a_im[], float b_re[], float b_im[],
+                             float w_re, float w_im, int count)
+{
+    __m512 wr = _mm512_set1_ps(w_re);
+    __m512 wi = _mm512_set1_ps(w_im);
+
+    for (int b = 0; b < count; b += 16)
+    {
+        __mmask16 mask = (count - b >= 16) ? (__mmask16)0xFFFF : tail_mask(count - b);
+
+        __m512 ar = _mm512_maskz_loadu_ps(mask, &a_re[b]), ai = _mm512_maskz_loadu_ps(mask, &a_im[b]);
+        __m512 br = _mm512_maskz_loadu_ps(mask, &b_re[b]), bi = _mm512_maskz_loadu_ps(mask, &b_im[b]);
+
+        __m512 tr = _mm512_fmsub_ps(br, wr, _mm512_mul_ps(bi, wi));
+        __m512 ti = _mm512_fmadd_ps(br, wi, _mm512_mul_ps(bi, wr));
+
+        _mm512_mask_storeu_ps(&a_re[b], mask, _mm512_add_ps(ar, tr));
+        _mm512_mask_storeu_ps(&a_im[b], mask, _mm512_add_ps(ai, ti));
+        _mm512_mask_storeu_ps(&b_re[b], mask, _mm512_sub_ps(ar, tr));
+        _mm512_mask_storeu_ps(&b_im[b], mask, _mm512_sub_ps(ai, ti));
+    }
+}
+
+static void complex_mac_avx512(float acc_re[], float acc_im[], const float x_re[], const float x_im[],
+                               float w_re, float w_im, int count)
+{
+    __m512 wr = _mm512_set1_ps(w_re);
+    __m512 wi = _mm512_set1_ps(w_im);
+
+    for (int b = 0; b < count; b += 16)
+    {
+        __mmask16 mask = (count - b >= 16) ? (__mmask16)0xFFFF : tail_mask(count - b);
+
+        __m512 xr = _mm512_maskz_loadu_ps(mask, &x_re[b]), xi = _mm512_maskz_loadu_ps(mask, &x_im[b]);
+        __m512 ar = _mm512_maskz_loadu_ps(mask, &acc_re[b]), ai = _mm512_maskz_loadu_ps(mask, &acc_im[b]);
+
+        ar = _mm512_fnmadd_ps(xi, wi, _mm512_fmadd_ps(xr, wr, ar));
+        ai = _mm512_fmadd_ps(xi, wr, _mm512_fmadd_ps(xr, wi, ai));
+
+        _mm512_mask_storeu_ps(&acc_re[b], mask, ar);
+        _mm512_mask_storeu_ps(&acc_im[b], mask, ai);
+    }
+}
+
+static void complex_mul_avx512(float out_re[], float out_im[], const float x_re[], const float x_im[],
+                               float w_re, float w_im, int count)
+{
+    __m512 wr = _mm512_set1_ps(w_re);
+    __m512 wi = _mm512_set1_ps(w_im);
+
+    for (int b = 0; b < count; b += 16)
+    {
+        __mmask16 mask = (count - b >= 16) ? (__mmask16)0xFFFF : tail_mask(count - b);
+
+        __m512 xr = _mm512_maskz_loadu_ps(mask, &x_re[b]), xi = _mm512_maskz_loadu_ps(mask, &x_im[b]);
+
+        _mm512_mask_storeu_ps(&out_re[b], mask, _mm512_fmsub_ps(xr, wr, _mm512_mul_ps(xi, wi)));
+        _mm512_mask_storeu_ps(&out_im[b], mask, _mm512_fmadd_ps(xr, wi, _mm512_mul_ps(xi, wr)));
+    }
+}
+
+const FFTKernels fft_kernels_avx512 = {
+        "AVX-512F",
+        butterfly_avx512,
+        complex_mac_avx512,
+        complex_mul_avx512
+};
+
+#endif
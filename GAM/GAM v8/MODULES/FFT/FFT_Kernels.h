@@ -0,0 +1,33 @@
+#ifndef GAM_FFT_KERNELS_H
+#define GAM_FFT_KERNELS_H
+
+#include "../../MODULES/Common.h"
+
+
+// NÚCLEOS SOBRE CARRILES (formato separado re/im, count carriles contiguos)
+typedef struct {
+    const char *name;
+
+    // a = a + w*b, b = a - w*b
+    void (*butterfly)(float a_re[], float a_im[], float b_re[], float b_im[],
+                      float w_re, float w_im, int count);
+
+    // acc += w*x
+    void (*complex_mac)(float acc_re[], float acc_im[], const float x_re[], const float x_im[],
+                        float w_re, float w_im, int count);
+
+    // out = w*x
+    void (*complex_mul)(float out_re[], float out_im[], const float x_re[], const float x_im[],
+                        float w_re, float w_im, int count);
+} FFTKernels;
+
+
+extern const FFTKernels fft_kernels_scalar;
+
+#ifdef GAM_FFT_X86_KERNELS
+extern const FFTKernels fft_kernels_avx2;
+extern const FFTKernels fft_kernels_avx512;
+#endif
+
+
+#endif //GAM_FFT_KERNELS_H
@@ -1,58 +1,126 @@
 #include "Frame.h"
+#include "../FFT/FFT.h"
 
 // PREÁMBULO Y DETECCIÓN
+#if PREAMBLE_REPEATED_HALF
+    #if PREAMBLE_LEN % 2 != 0
+        #error "El preambulo de mitades repetidas requiere PREAMBLE_LEN par"
+    #endif
+    #define PREAMBLE_PERIOD (PREAMBLE_LEN / 2)
+#else
+    #define PREAMBLE_PERIOD 32
+#endif
+
 bool generate_preamble_bpsk(float complex preamble[PREAMBLE_LEN])
 {
     uint32_t sync = PREAMBLE_SYNC_WORD;
 
+    // Con PREAMBLE_REPEATED_HALF la segunda mitad repite la primera
     for (int i = 0; i < PREAMBLE_LEN; i++)
     {
-        uint8_t bit = (sync >> (i % 32)) & 1;
+        uint8_t bit = (sync >> ((i % PREAMBLE_PERIOD) % 32)) & 1;
         preamble[i] = (bit == 0) ? (1.0f + 0.0f * I) : (-1.0f + 0.0f * I);
     }
 
     return false;
 }
 
-float calculate_correlation(const float complex received_signal[], int start_index, int length)
+// CORRELADOR DE VENTANA DESLIZANTE
+bool init_preamble_correlator(PreambleCorrelator *correlator)
+{
+    float complex preamble[PREAMBLE_LEN];
+
+    if (!correlator || generate_preamble_bpsk(preamble))
+    {
+        printf("Error: No se pudo inicializar el correlador de preambulo\n");
+        return true;
+    }
+
+    correlator->reference_power = 0.0f;
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        correlator->reference_re[i] = crealf(preamble[i]);
+        correlator->reference_im[i] = -cimagf(preamble[i]);
+        correlator->reference_power += crealf(preamble[i]) * crealf(preamble[i]) +
+                                       cimagf(preamble[i]) * cimagf(preamble[i]);
+    }
+
+    correlator->received_power = 0.0;
+    correlator->window_start = 0;
+    correlator->initialized = true;
+
+    return false;
+}
+
+void reset_preamble_correlator(PreambleCorrelator *correlator, const float complex received_signal[],
+                               int start_index)
 {
-    float complex local_preamble[PREAMBLE_LEN];
+    correlator->received_power = 0.0;
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        float complex r = received_signal[start_index + i];
+        correlator->received_power += crealf(r) * crealf(r) + cimagf(r) * cimagf(r);
+    }
+
+    correlator->window_start = start_index;
+}
+
+// Correlación normalizada en window_start y avance de una muestra (potencia en O(1))
+float preamble_correlator_next(PreambleCorrelator *correlator, const float complex received_signal[], int length)
+{
+    int start = correlator->window_start;
+    if (start + PREAMBLE_LEN > length) return 0.0f;
+
+    const float complex *window = &received_signal[start];
     float correlation_real = 0.0f;
     float correlation_imag = 0.0f;
-    float power_received = 0.0f;
-    float power_local = 0.0f;
 
-    generate_preamble_bpsk(local_preamble);
+    // Producto complejo completo r * conj(p), incluidos los términos cruzados
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        float r_re = crealf(window[i]);
+        float r_im = cimagf(window[i]);
 
-    // Verificar que tenemos suficientes muestras
-    if (start_index + PREAMBLE_LEN > length) {
-        return 0.0f;
+        correlation_real += r_re * correlator->reference_re[i] - r_im * correlator->reference_im[i];
+        correlation_imag += r_re * correlator->reference_im[i] + r_im * correlator->reference_re[i];
     }
 
-    for (int i = 0; i < PREAMBLE_LEN; i++) {
-        int current_index = start_index + i;
+    float power_received = (float)correlator->received_power;
+    float metric = 0.0f;
 
-        // Correlación compleja completa
-        correlation_real += crealf(received_signal[current_index]) * crealf(local_preamble[i]);
-        correlation_imag += cimagf(received_signal[current_index]) * cimagf(local_preamble[i]);
+    // Normalización para hacerla invariante a la potencia
+    if (power_received > 0 && correlator->reference_power > 0)
+    {
+        metric = sqrtf(correlation_real * correlation_real + correlation_imag * correlation_imag) /
+                 sqrtf(power_received * correlator->reference_power);
+    }
 
-        // Potencias para normalización
-        power_received += crealf(received_signal[current_index]) * crealf(received_signal[current_index]) +
-                          cimagf(received_signal[current_index]) * cimagf(received_signal[current_index]);
-        power_local += crealf(local_preamble[i]) * crealf(local_preamble[i]) +
-                       cimagf(local_preamble[i]) * cimagf(local_preamble[i]);
+    // Deslizar la ventana: sale r[start], entra r[start + PREAMBLE_LEN]
+    float complex leaving = window[0];
+    correlator->received_power -= crealf(leaving) * crealf(leaving) + cimagf(leaving) * cimagf(leaving);
+    if (start + PREAMBLE_LEN < length)
+    {
+        float complex entering = window[PREAMBLE_LEN];
+        correlator->received_power += crealf(entering) * crealf(entering) + cimagf(entering) * cimagf(entering);
     }
+    if (correlator->received_power < 0.0) correlator->received_power = 0.0;
+    correlator->window_start = start + 1;
 
-    // Correlación compleja total
-    float correlation_magnitude = sqrtf(correlation_real * correlation_real +
-                                        correlation_imag * correlation_imag);
+    return metric;
+}
 
-    // Normalización para hacerla invariante a la potencia
-    if (power_received > 0 && power_local > 0) {
-        return correlation_magnitude / sqrtf(power_received * power_local);
+float calculate_correlation(const float complex received_signal[], int start_index, int length)
+{
+    PreambleCorrelator correlator;
+
+    // Verificar que tenemos suficientes muestras
+    if (start_index + PREAMBLE_LEN > length || init_preamble_correlator(&correlator)) {
+        return 0.0f;
     }
 
-    return 0.0f;
+    reset_preamble_correlator(&correlator, received_signal, start_index);
+
+    return preamble_correlator_next(&correlator, received_signal, length);
 }
 
 bool detect_frame_start(const float complex received_signal[], int length, int *frame_start_index) {
@@ -69,10 +137,15 @@ bool detect_frame_start(const float complex received_signal[], int length, int *
         return true;
     }
 
+    // Referencia generada una sola vez para toda la búsqueda
+    PreambleCorrelator correlator;
+    if (init_preamble_correlator(&correlator)) return true;
+    reset_preamble_correlator(&correlator, received_signal, 0);
+
     printf("Buscando preambulo en ventana de %d muestras...\n", search_window);
 
     for (int i = 0; i < search_window; i++) {
-        float correlation = calculate_correlation(received_signal, i, length);
+        float correlation = preamble_correlator_next(&correlator, received_signal, length);
 
         if (correlation > max_correlation) {
             max_correlation = correlation;
@@ -94,6 +167,717 @@ bool detect_frame_start(const float complex received_signal[], int length, int *
 }
 
 
+// ADQUISICIÓN EN DOS ETAPAS (signo 1-bit + popcount, después refinado float)
+#if PREAMBLE_LEN > 64
+    #error "La etapa 1-bit requiere PREAMBLE_LEN <= 64"
+#endif
+
+static inline int popcount64(uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Inserta un candidato en la lista ordenada (mayor métrica primero)
+static void push_coarse_candidate(int indices[], int metrics[], int *count, int index, int metric)
+{
+    // Un candidato vecino del mismo pico ocupa un solo hueco
+    for (int c = 0; c < *count; c++)
+    {
+        if (abs(indices[c] - index) <= 1)
+        {
+            if (metric <= metrics[c]) return;
+            for (int k = c; k < *count - 1; k++) { indices[k] = indices[k + 1]; metrics[k] = metrics[k + 1]; }
+            (*count)--;
+            break;
+        }
+    }
+
+    if (*count == COARSE_CANDIDATES && metric <= metrics[*count - 1]) return;
+
+    int pos = (*count < COARSE_CANDIDATES) ? (*count)++ : COARSE_CANDIDATES - 1;
+    while (pos > 0 && metrics[pos - 1] < metric)
+    {
+        indices[pos] = indices[pos - 1];
+        metrics[pos] = metrics[pos - 1];
+        pos--;
+    }
+    indices[pos] = index;
+    metrics[pos] = metric;
+}
+
+bool find_coarse_preamble_candidates(const float complex received_signal[], int length,
+                                     int candidate_index[COARSE_CANDIDATES], int *num_candidates)
+{
+    int search_window = length - PREAMBLE_LEN;
+
+    if (!candidate_index || !num_candidates || search_window <= 0) {
+        printf("Error: Ventana de busqueda insuficiente (%d)\n", search_window);
+        return true;
+    }
+
+    // Preámbulo empaquetado: bit i = 1 si el símbolo i es -1
+    float complex preamble[PREAMBLE_LEN];
+    generate_preamble_bpsk(preamble);
+
+    uint64_t preamble_bits = 0;
+    uint64_t preamble_mask = (PREAMBLE_LEN == 64) ? ~0ULL : ((1ULL << PREAMBLE_LEN) - 1ULL);
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        if (crealf(preamble[i]) < 0.0f) preamble_bits |= 1ULL << i;
+    }
+
+    // Etapa 1: cuantificar I/Q a bits de signo (una palabra extra de relleno)
+    int num_words = (length + 63) / 64 + 1;
+    uint64_t *sign_i = calloc((size_t)num_words, sizeof(uint64_t));
+    uint64_t *sign_q = calloc((size_t)num_words, sizeof(uint64_t));
+    if (!sign_i || !sign_q)
+    {
+        printf("Error: Sin memoria para correlador 1-bit\n");
+        free(sign_i);
+        free(sign_q);
+        return true;
+    }
+
+    for (int w = 0; w * 64 < length; w++)
+    {
+        const float complex *chunk = &received_signal[w * 64];
+        int count = (length - w * 64 < 64) ? length - w * 64 : 64;
+        uint64_t bits_i = 0, bits_q = 0;
+
+        for (int j = 0; j < count; j++)
+        {
+            bits_i |= (uint64_t)(crealf(chunk[j]) < 0.0f) << j;
+            bits_q |= (uint64_t)(cimagf(chunk[j]) < 0.0f) << j;
+        }
+        sign_i[w] = bits_i;
+        sign_q[w] = bits_q;
+    }
+
+    int candidate_metric[COARSE_CANDIDATES];
+    *num_candidates = 0;
+
+    // 64 desplazamientos por pareja de palabras: XOR + popcount
+    for (int w = 0; w * 64 < search_window; w++)
+    {
+        uint64_t i0 = sign_i[w], i1 = sign_i[w + 1];
+        uint64_t q0 = sign_q[w], q1 = sign_q[w + 1];
+        int lags = search_window - w * 64;
+        if (lags > 64) lags = 64;
+
+        for (int lag = 0; lag < lags; lag++)
+        {
+            // (x << 1) << (63 - lag) evita el desplazamiento indefinido de 64 bits con lag = 0
+            uint64_t window_i = (i0 >> lag) | ((i1 << 1) << (63 - lag));
+            uint64_t window_q = (q0 >> lag) | ((q1 << 1) << (63 - lag));
+
+            int corr_i = PREAMBLE_LEN - 2 * popcount64((window_i ^ preamble_bits) & preamble_mask);
+            int corr_q = PREAMBLE_LEN - 2 * popcount64((window_q ^ preamble_bits) & preamble_mask);
+            int metric = corr_i * corr_i + corr_q * corr_q;
+
+            if (*num_candidates < COARSE_CANDIDATES || metric > candidate_metric[*num_candidates - 1])
+            {
+                push_coarse_candidate(candidate_index, candidate_metric, num_candidates, w * 64 + lag, metric);
+            }
+        }
+    }
+
+    free(sign_i);
+    free(sign_q);
+
+    return false;
+}
+
+bool detect_frame_start_two_stage(const float complex received_signal[], int length, int *frame_start_index)
+{
+    int search_window = length - PREAMBLE_LEN;
+
+    int candidate_index[COARSE_CANDIDATES];
+    int num_candidates;
+    if (find_coarse_preamble_candidates(received_signal, length, candidate_index, &num_candidates)) return true;
+
+    // Etapa 2: correlación float normalizada solo en los candidatos (±1 muestra)
+    PreambleCorrelator correlator;
+    if (init_preamble_correlator(&correlator)) return true;
+
+    float max_correlation = -FLT_MAX;
+    int best_index = -1;
+
+    for (int c = 0; c < num_candidates; c++)
+    {
+        for (int d = -1; d <= 1; d++)
+        {
+            int index = candidate_index[c] + d;
+            if (index < 0 || index >= search_window) continue;
+
+            reset_preamble_correlator(&correlator, received_signal, index);
+            float correlation = preamble_correlator_next(&correlator, received_signal, length);
+
+            if (correlation > max_correlation)
+            {
+                max_correlation = correlation;
+                best_index = index;
+            }
+        }
+    }
+
+    printf("Adquisicion 2 etapas: %d candidatos, mejor correlacion %.6f en indice %d\n",
+           num_candidates, max_correlation, best_index);
+
+    if (max_correlation > CORRELATION_THRESHOLD) {
+        *frame_start_index = best_index + PREAMBLE_LEN;
+        printf("Preambulo detectado! Inicio de trama en: %d\n", *frame_start_index);
+        return false;
+    }
+
+    printf("Preambulo NO detectado (umbral: %.3f, mejor: %.6f)\n", CORRELATION_THRESHOLD, max_correlation);
+    return true;
+}
+
+
+// TIMING + CFO GRUESO SCHMIDL-COX (requiere PREAMBLE_REPEATED_HALF)
+void correct_cfo_time_domain(float complex signal[], int length, float cfo)
+{
+    // NCO: fasor multiplicado por e^(-j·cfo) en cada muestra, renormalizado periódicamente
+    float step_re = cosf(-cfo), step_im = sinf(-cfo);
+    float phasor_re = 1.0f, phasor_im = 0.0f;
+
+    for (int n = 0; n < length; n++)
+    {
+        float s_re = crealf(signal[n]), s_im = cimagf(signal[n]);
+        signal[n] = (s_re * phasor_re - s_im * phasor_im) + (s_re * phasor_im + s_im * phasor_re) * I;
+
+        float next_re = phasor_re * step_re - phasor_im * step_im;
+        float next_im = phasor_re * step_im + phasor_im * step_re;
+        phasor_re = next_re;
+        phasor_im = next_im;
+
+        if ((n & 255) == 255)
+        {
+            float magnitude = sqrtf(phasor_re * phasor_re + phasor_im * phasor_im);
+            phasor_re /= magnitude;
+            phasor_im /= magnitude;
+        }
+    }
+}
+
+bool detect_frame_start_schmidl_cox(const float complex received_signal[], int length, SchmidlCoxResult *result)
+{
+    const int half = PREAMBLE_LEN / 2;
+    int search_window = length - PREAMBLE_LEN + 1;
+
+    if (!result || search_window <= 0)
+    {
+        printf("Error: Ventana de busqueda insuficiente (%d)\n", search_window);
+        return true;
+    }
+
+    // P(d) = sum conj(r[d+m]) r[d+m+H], E1/E2 = energía de cada mitad, m < H
+    // Métrica |P|^2 / (E1 E2) acotada en [0, 1] (Cauchy-Schwarz)
+    double p_re = 0.0, p_im = 0.0, energy_first = 0.0, energy_second = 0.0;
+    for (int m = 0; m < half; m++)
+    {
+        float complex a = received_signal[m], b = received_signal[m + half];
+        p_re += crealf(a) * crealf(b) + cimagf(a) * cimagf(b);
+        p_im += crealf(a) * cimagf(b) - cimagf(a) * crealf(b);
+        energy_first += crealf(a) * crealf(a) + cimagf(a) * cimagf(a);
+        energy_second += crealf(b) * crealf(b) + cimagf(b) * cimagf(b);
+    }
+
+    float best_metric = -1.0f;
+    double best_p_re = 0.0, best_p_im = 0.0;
+    int best_index = -1;
+
+    for (int d = 0; d < search_window; d++)
+    {
+        // Tras el primer cruce del umbral solo se busca el máximo durante PREAMBLE_LEN muestras
+        if (best_index >= 0 && best_metric >= SCHMIDL_COX_THRESHOLD && d - best_index > PREAMBLE_LEN) break;
+
+        double energy = energy_first * energy_second;
+        if (energy > 0.0)
+        {
+            float metric = (float)((p_re * p_re + p_im * p_im) / energy);
+            if (metric > best_metric)
+            {
+                best_metric = metric;
+                best_index = d;
+                best_p_re = p_re;
+                best_p_im = p_im;
+            }
+        }
+
+        // Actualización recursiva O(1): entra el par (d+H, d+2H), sale (d, d+H)
+        if (d + 1 < search_window)
+        {
+            float complex out_a = received_signal[d], out_b = received_signal[d + half];
+            float complex in_a = received_signal[d + half], in_b = received_signal[d + 2 * half];
+
+            p_re += (crealf(in_a) * crealf(in_b) + cimagf(in_a) * cimagf(in_b)) -
+                    (crealf(out_a) * crealf(out_b) + cimagf(out_a) * cimagf(out_b));
+            p_im += (crealf(in_a) * cimagf(in_b) - cimagf(in_a) * crealf(in_b)) -
+                    (crealf(out_a) * cimagf(out_b) - cimagf(out_a) * crealf(out_b));
+            energy_first += (crealf(in_a) * crealf(in_a) + cimagf(in_a) * cimagf(in_a)) -
+                            (crealf(out_a) * crealf(out_a) + cimagf(out_a) * cimagf(out_a));
+            energy_second += (crealf(in_b) * crealf(in_b) + cimagf(in_b) * cimagf(in_b)) -
+                             (crealf(out_b) * crealf(out_b) + cimagf(out_b) * cimagf(out_b));
+            if (energy_first < 0.0) energy_first = 0.0;
+            if (energy_second < 0.0) energy_second = 0.0;
+        }
+    }
+
+    if (best_index < 0 || best_metric < SCHMIDL_COX_THRESHOLD)
+    {
+        printf("Schmidl-Cox: preambulo NO detectado (umbral: %.3f, mejor: %.6f)\n",
+               SCHMIDL_COX_THRESHOLD, best_metric);
+        return true;
+    }
+
+    // CFO grueso: fase de P en el pico / H (rango ±π/H rad/muestra)
+    float cfo = atan2f((float)best_p_im, (float)best_p_re) / (float)half;
+
+    // Precisión: SNR del preámbulo a partir de la métrica (M = (SNR / (1 + SNR))^2), var(arg P) ~ 1 / (H SNR)
+    float root_metric = sqrtf(best_metric < 0.999f ? best_metric : 0.999f);
+    float preamble_snr = root_metric / (1.0f - root_metric);
+    float cfo_std = 1.0f / ((float)half * sqrtf((float)half * preamble_snr));
+
+    // Refinado del timing con correlación cruzada sobre una copia corregida en CFO (±H/2)
+    int refine_start = best_index - half / 2;
+    if (refine_start < 0) refine_start = 0;
+    int refine_end = best_index + half / 2;
+    if (refine_end > length - PREAMBLE_LEN) refine_end = length - PREAMBLE_LEN;
+
+    int local_length = refine_end - refine_start + PREAMBLE_LEN;
+    float complex local[local_length];
+    for (int i = 0; i < local_length; i++) { local[i] = received_signal[refine_start + i]; }
+    correct_cfo_time_domain(local, local_length, cfo);
+
+    PreambleCorrelator correlator;
+    if (init_preamble_correlator(&correlator)) return true;
+    reset_preamble_correlator(&correlator, local, 0);
+
+    float best_correlation = -1.0f;
+    int refined_index = best_index;
+    for (int d = 0; d <= refine_end - refine_start; d++)
+    {
+        float correlation = preamble_correlator_next(&correlator, local, local_length);
+        if (correlation > best_correlation)
+        {
+            best_correlation = correlation;
+            refined_index = refine_start + d;
+        }
+    }
+
+    result->preamble_index = refined_index;
+    result->frame_start = refined_index + PREAMBLE_LEN;
+    result->metric = best_metric;
+    result->cfo = cfo;
+    result->cfo_std = cfo_std;
+
+    printf("Schmidl-Cox: metrica %.4f, inicio de trama %d, CFO grueso %.6f +/- %.6f rad/muestra (%.3f subportadoras)\n",
+           best_metric, result->frame_start, cfo, cfo_std, cfo * N_FFT / (2.0f * (float)M_PI));
+
+    return false;
+}
+
+
+// BANCO DE HIPÓTESIS DE CFO (búsqueda conjunta tiempo/frecuencia)
+bool init_cfo_bank_detector(CFOBankDetector *detector)
+{
+    if (!detector) return true;
+
+    // Estado liberable antes de cualquier fallo (free_cfo_bank_detector es seguro tras un error)
+    detector->initialized = false;
+    detector->batch_re = NULL;
+    detector->batch_im = NULL;
+    detector->plan.twiddles = NULL;
+    detector->plan.bit_reverse = NULL;
+    detector->plan.initialized = false;
+    if (init_fft_plan(&detector->plan, CFO_BANK_FFT_SIZE))
+    {
+        // init_fft_plan libera sus tablas al fallar pero no anula los punteros
+        detector->plan.twiddles = NULL;
+        detector->plan.bit_reverse = NULL;
+        return true;
+    }
+
+    size_t batch_samples = (size_t)CFO_BANK_FFT_SIZE * CFO_BANK_BATCH;
+    detector->batch_re = malloc(batch_samples * sizeof(float));
+    detector->batch_im = malloc(batch_samples * sizeof(float));
+    if (!detector->batch_re || !detector->batch_im)
+    {
+        printf("Error: Sin memoria para banco de CFO\n");
+        free_cfo_bank_detector(detector);
+        return true;
+    }
+
+    float complex preamble[PREAMBLE_LEN];
+    generate_preamble_bpsk(preamble);
+
+    detector->reference_power = 0.0f;
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        detector->reference_re[i] = crealf(preamble[i]);
+        detector->reference_im[i] = -cimagf(preamble[i]);
+        detector->reference_power += crealf(preamble[i]) * crealf(preamble[i]) +
+                                     cimagf(preamble[i]) * cimagf(preamble[i]);
+    }
+
+    // Bin k elimina un CFO de 2πk / CFO_BANK_FFT_SIZE rad/muestra
+    detector->max_bin = (int)(CFO_BANK_MAX_CFO * CFO_BANK_FFT_SIZE / (2.0 * M_PI)) + 1;
+    if (detector->max_bin > CFO_BANK_FFT_SIZE / 2 - 1) detector->max_bin = CFO_BANK_FFT_SIZE / 2 - 1;
+
+    detector->initialized = true;
+
+    return false;
+}
+
+void free_cfo_bank_detector(CFOBankDetector *detector)
+{
+    if (!detector) return;
+
+    free_fft_plan(&detector->plan);
+    free(detector->batch_re);
+    free(detector->batch_im);
+    detector->batch_re = NULL;
+    detector->batch_im = NULL;
+    detector->initialized = false;
+}
+
+// |sum r[d + n] conj(p[n]) e^(-j2πkn/K)|^2 para un único (d, k), usado en la interpolación
+static float cfo_bank_bin_power(const CFOBankDetector *detector, const float complex window[], int bin)
+{
+    float acc_re = 0.0f, acc_im = 0.0f;
+
+    for (int n = 0; n < PREAMBLE_LEN; n++)
+    {
+        float r_re = crealf(window[n]), r_im = cimagf(window[n]);
+        float z_re = r_re * detector->reference_re[n] - r_im * detector->reference_im[n];
+        float z_im = r_re * detector->reference_im[n] + r_im * detector->reference_re[n];
+        float angle = -2.0f * (float)M_PI * (float)bin * (float)n / (float)CFO_BANK_FFT_SIZE;
+        float c = cosf(angle), sn = sinf(angle);
+
+        acc_re += z_re * c - z_im * sn;
+        acc_im += z_re * sn + z_im * c;
+    }
+
+    return acc_re * acc_re + acc_im * acc_im;
+}
+
+bool detect_frame_start_cfo_bank(CFOBankDetector *detector, const float complex received_signal[], int length,
+                                 CFOBankResult *result)
+{
+    const int fft_size = CFO_BANK_FFT_SIZE;
+    const int batch = CFO_BANK_BATCH;
+    int offsets = length - PREAMBLE_LEN + 1;
+
+    if (!detector || !detector->initialized || !result)
+    {
+        printf("Error: Banco de CFO no inicializado\n");
+        return true;
+    }
+    if (offsets <= 0)
+    {
+        printf("Error: Ventana de busqueda insuficiente (%d)\n", offsets);
+        return true;
+    }
+
+    float *re = detector->batch_re;
+    float *im = detector->batch_im;
+
+    double received_power = 0.0;
+    for (int n = 0; n < PREAMBLE_LEN; n++)
+    {
+        received_power += crealf(received_signal[n]) * crealf(received_signal[n]) +
+                          cimagf(received_signal[n]) * cimagf(received_signal[n]);
+    }
+
+    float best_metric = -1.0f;
+    int best_index = -1;
+    int best_bin = 0;
+
+    for (int base = 0; base < offsets; base += batch)
+    {
+        int count = (offsets - base < batch) ? offsets - base : batch;
+
+        // z_b[n] = r[base + b + n] conj(p[n]) con ceros hasta K: una columna del lote por desplazamiento
+        for (int n = 0; n < PREAMBLE_LEN; n++)
+        {
+            float ref_re = detector->reference_re[n], ref_im = detector->reference_im[n];
+            float *row_re = &re[n * batch], *row_im = &im[n * batch];
+
+            for (int b = 0; b < count; b++)
+            {
+                float complex r = received_signal[base + b + n];
+                row_re[b] = crealf(r) * ref_re - cimagf(r) * ref_im;
+                row_im[b] = crealf(r) * ref_im + cimagf(r) * ref_re;
+            }
+            for (int b = count; b < batch; b++) { row_re[b] = 0.0f; row_im[b] = 0.0f; }
+        }
+        for (int i = PREAMBLE_LEN * batch; i < fft_size * batch; i++) { re[i] = 0.0f; im[i] = 0.0f; }
+
+        // Todas las hipótesis de CFO de los B desplazamientos en una FFT en lote
+        if (fft_batch_forward(&detector->plan, re, im, batch)) return true;
+
+        for (int b = 0; b < count; b++)
+        {
+            int offset = base + b;
+            float peak_power = 0.0f;
+            int peak_bin = 0;
+
+            for (int k = -detector->max_bin; k <= detector->max_bin; k++)
+            {
+                int row = (k & (fft_size - 1)) * batch + b;
+                float bin_power = re[row] * re[row] + im[row] * im[row];
+                if (bin_power > peak_power)
+                {
+                    peak_power = bin_power;
+                    peak_bin = k;
+                }
+            }
+
+            if (received_power > 0.0)
+            {
+                float metric = sqrtf(peak_power / (float)(received_power * detector->reference_power));
+                if (metric > best_metric)
+                {
+                    best_metric = metric;
+                    best_index = offset;
+                    best_bin = peak_bin;
+                }
+            }
+
+            // Potencia recibida de la ventana siguiente en O(1)
+            float complex leaving = received_signal[offset];
+            received_power -= crealf(leaving) * crealf(leaving) + cimagf(leaving) * cimagf(leaving);
+            if (offset + PREAMBLE_LEN < length)
+            {
+                float complex entering = received_signal[offset + PREAMBLE_LEN];
+                received_power += crealf(entering) * crealf(entering) + cimagf(entering) * cimagf(entering);
+            }
+            if (received_power < 0.0) received_power = 0.0;
+        }
+    }
+
+    if (best_index < 0 || best_metric < CORRELATION_THRESHOLD)
+    {
+        printf("Banco CFO: preambulo NO detectado (umbral: %.3f, mejor: %.6f)\n",
+               CORRELATION_THRESHOLD, best_metric);
+        return true;
+    }
+
+    // Interpolación parabólica entre bins vecinos para el CFO fino
+    const float complex *window = &received_signal[best_index];
+    float left = sqrtf(cfo_bank_bin_power(detector, window, best_bin - 1));
+    float center = sqrtf(cfo_bank_bin_power(detector, window, best_bin));
+    float right = sqrtf(cfo_bank_bin_power(detector, window, best_bin + 1));
+    float denominator = left - 2.0f * center + right;
+    float delta = (fabsf(denominator) > 1e-12f) ? 0.5f * (left - right) / denominator : 0.0f;
+    if (delta > 0.5f) delta = 0.5f;
+    if (delta < -0.5f) delta = -0.5f;
+
+    result->preamble_index = best_index;
+    result->frame_start = best_index + PREAMBLE_LEN;
+    result->hypothesis = best_bin;
+    result->metric = best_metric;
+    result->cfo = 2.0f * (float)M_PI * ((float)best_bin + delta) / (float)fft_size;
+
+    printf("Banco CFO: correlacion %.4f, inicio de trama %d, CFO %.6f rad/muestra (hipotesis %d de +/-%d)\n",
+           best_metric, result->frame_start, result->cfo, best_bin, detector->max_bin);
+
+    return false;
+}
+
+
+// CORRELADOR OVERLAP-SAVE
+bool init_overlap_save_correlator(OverlapSaveCorrelator *correlator, int block_size)
+{
+    if (!correlator) return true;
+
+    if (block_size <= 0) block_size = OVERLAP_SAVE_BLOCK;
+    if (block_size < 2 * PREAMBLE_LEN || (block_size & (block_size - 1)) != 0)
+    {
+        printf("Error: Bloque overlap-save no valido (%d)\n", block_size);
+        return true;
+    }
+
+    if (init_fft_plan(&correlator->plan, block_size)) return true;
+
+    correlator->reference_spectrum = malloc((size_t)block_size * sizeof(float complex));
+    correlator->block = malloc((size_t)block_size * sizeof(float complex));
+    if (!correlator->reference_spectrum || !correlator->block)
+    {
+        printf("Error: Sin memoria para correlador overlap-save\n");
+        free_overlap_save_correlator(correlator);
+        return true;
+    }
+
+    float complex preamble[PREAMBLE_LEN];
+    generate_preamble_bpsk(preamble);
+
+    // Correlación circular: c[d] = IFFT(FFT(x) * conj(FFT(p)))[d]
+    correlator->reference_power = 0.0f;
+    for (int i = 0; i < block_size; i++)
+    {
+        correlator->reference_spectrum[i] = (i < PREAMBLE_LEN) ? preamble[i] : 0.0f + 0.0f * I;
+    }
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        correlator->reference_power += crealf(preamble[i]) * crealf(preamble[i]) +
+                                       cimagf(preamble[i]) * cimagf(preamble[i]);
+    }
+
+    fft_forward(&correlator->plan, correlator->reference_spectrum, correlator->reference_spectrum);
+
+    // Se incluye la escala 1/B de la IFFT en la referencia
+    for (int i = 0; i < block_size; i++)
+    {
+        correlator->reference_spectrum[i] = conjf(correlator->reference_spectrum[i]) / (float)block_size;
+    }
+
+    correlator->block_size = block_size;
+    correlator->step = block_size - PREAMBLE_LEN + 1;
+    correlator->initialized = true;
+
+    return false;
+}
+
+void free_overlap_save_correlator(OverlapSaveCorrelator *correlator)
+{
+    if (!correlator) return;
+
+    free_fft_plan(&correlator->plan);
+    free(correlator->reference_spectrum);
+    free(correlator->block);
+    correlator->reference_spectrum = NULL;
+    correlator->block = NULL;
+    correlator->initialized = false;
+}
+
+// Inserta un pico respetando la separación mínima (se queda con el mayor)
+static void push_preamble_peak(PreamblePeak peaks[], int max_peaks, int *num_peaks,
+                               int index, float metric, int min_distance)
+{
+    if (*num_peaks > 0 && index - peaks[*num_peaks - 1].index < min_distance)
+    {
+        if (metric > peaks[*num_peaks - 1].metric)
+        {
+            peaks[*num_peaks - 1].index = index;
+            peaks[*num_peaks - 1].metric = metric;
+        }
+        return;
+    }
+
+    if (*num_peaks < max_peaks)
+    {
+        peaks[*num_peaks].index = index;
+        peaks[*num_peaks].metric = metric;
+        (*num_peaks)++;
+    }
+}
+
+bool find_preambles_overlap_save(OverlapSaveCorrelator *correlator, const float complex received_signal[],
+                                 int length, float threshold, int min_distance,
+                                 PreamblePeak peaks[], int max_peaks, int *num_peaks)
+{
+    if (!correlator || !correlator->initialized || !peaks || !num_peaks)
+    {
+        printf("Error: Correlador overlap-save no inicializado\n");
+        return true;
+    }
+    if (max_peaks <= 0)
+    {
+        printf("Error: Lista de preambulos sin capacidad (%d)\n", max_peaks);
+        return true;
+    }
+
+    *num_peaks = 0;
+    int search_window = length - PREAMBLE_LEN + 1;
+    if (search_window <= 0) return false;
+
+    int block_size = correlator->block_size;
+    bool truncated = false;
+
+    // Potencia de la ventana [d, d + PREAMBLE_LEN) como suma móvil sobre toda la captura
+    double window_power = 0.0;
+    for (int i = 0; i < PREAMBLE_LEN; i++)
+    {
+        window_power += crealf(received_signal[i]) * crealf(received_signal[i]) +
+                        cimagf(received_signal[i]) * cimagf(received_signal[i]);
+    }
+
+    for (int block_start = 0; block_start < search_window; block_start += correlator->step)
+    {
+        // Bloque de B muestras (con ceros al final de la captura)
+        for (int i = 0; i < block_size; i++)
+        {
+            int idx = block_start + i;
+            correlator->block[i] = (idx < length) ? received_signal[idx] : 0.0f + 0.0f * I;
+        }
+
+        fft_forward(&correlator->plan, correlator->block, correlator->block);
+        for (int i = 0; i < block_size; i++)
+        {
+            float complex x = correlator->block[i];
+            float complex h = correlator->reference_spectrum[i];
+            correlator->block[i] = (crealf(x) * crealf(h) - cimagf(x) * cimagf(h)) +
+                                   (crealf(x) * cimagf(h) + cimagf(x) * crealf(h)) * I;
+        }
+        fft_inverse(&correlator->plan, correlator->block, correlator->block);
+
+        // Solo los primeros B - P + 1 desplazamientos no sufren aliasing circular
+        int valid = correlator->step;
+        if (block_start + valid > search_window) valid = search_window - block_start;
+
+        for (int d = 0; d < valid; d++)
+        {
+            int offset = block_start + d;
+            float complex c = correlator->block[d];
+            float power_received = (float)window_power;
+
+            if (power_received > 0)
+            {
+                float metric = sqrtf(crealf(c) * crealf(c) + cimagf(c) * cimagf(c)) /
+                               sqrtf(power_received * correlator->reference_power);
+
+                if (metric > threshold)
+                {
+                    if (*num_peaks == max_peaks && offset - peaks[max_peaks - 1].index >= min_distance)
+                    {
+                        truncated = true;
+                    }
+                    push_preamble_peak(peaks, max_peaks, num_peaks, offset, metric, min_distance);
+                }
+            }
+
+            // Deslizar la potencia de la ventana
+            float complex leaving = received_signal[offset];
+            window_power -= crealf(leaving) * crealf(leaving) + cimagf(leaving) * cimagf(leaving);
+            if (offset + PREAMBLE_LEN < length)
+            {
+                float complex entering = received_signal[offset + PREAMBLE_LEN];
+                window_power += crealf(entering) * crealf(entering) + cimagf(entering) * cimagf(entering);
+            }
+            if (window_power < 0.0) window_power = 0.0;
+        }
+    }
+
+    if (truncated)
+    {
+        printf("Advertencia: Mas de %d preambulos en la captura, lista truncada\n", max_peaks);
+    }
+
+    printf("Overlap-save: %d preambulos encontrados en %d muestras\n", *num_peaks, length);
+
+    return false;
+}
+
+
 // FORMACIÓN DE TRAMA
 bool add_preamble_to_prb_frame(const float complex ofdm_symbols_with_cp[PRB_SYMBOLS][N_FFT + CP_LEN],
                                float complex frame_with_preamble[PREAMBLE_LEN + PRB_SYMBOLS * (N_FFT + CP_LEN)])
@@ -123,6 +907,63 @@ bool add_preamble_to_prb_frame(const float complex ofdm_symbols_with_cp[PRB_SYMB
     return false;
 }
 
+bool init_frame_builder(FrameBuilder *builder, float complex frame[], int frame_length)
+{
+    return init_superframe_builder(builder, frame, frame_length, 1);
+}
+
+bool init_superframe_builder(FrameBuilder *builder, float complex frame[], int frame_length, int num_prbs)
+{
+    int required_length = PREAMBLE_LEN + num_prbs * PRB_PAYLOAD_SAMPLES;
+
+    if (!builder || !frame || num_prbs <= 0 || frame_length < required_length)
+    {
+        printf("Error: Buffer de trama insuficiente (%d < %d)\n", frame_length, required_length);
+        return true;
+    }
+
+    builder->frame = frame;
+    builder->length = frame_length;
+    builder->num_prbs = num_prbs;
+    builder->symbols_committed = 0;
+
+    // Un único preámbulo al principio del buffer para todos los PRBs
+    if (generate_preamble_bpsk(frame))
+    {
+        printf("Error generando preámbulo!\n");
+        return true;
+    }
+
+    builder->initialized = true;
+
+    return false;
+}
+
+float complex *frame_symbol_slot(const FrameBuilder *builder, int sym)
+{
+    if (!builder || !builder->initialized || sym < 0 || sym >= builder->num_prbs * PRB_SYMBOLS) return NULL;
+
+    // Cuerpo del símbolo (las CP_LEN muestras anteriores quedan para el prefijo); los PRBs van seguidos
+    return &builder->frame[PREAMBLE_LEN + sym * (N_FFT + CP_LEN) + CP_LEN];
+}
+
+bool commit_frame_symbol(FrameBuilder *builder, int sym)
+{
+    float complex *body = frame_symbol_slot(builder, sym);
+    if (!body)
+    {
+        printf("Error: Simbolo %d fuera de la trama\n", sym);
+        return true;
+    }
+
+    // Prefijo cíclico copiado desde el propio buffer de la trama
+    for (int i = 0; i < CP_LEN; i++) { body[i - CP_LEN] = body[N_FFT - CP_LEN + i]; }
+
+    builder->symbols_committed++;
+
+    return false;
+}
+
 bool extract_ofdm_from_frame(const float complex frame_with_preamble[], int frame_start_index,
                              float complex ofdm_symbols_with_cp[PRB_SYMBOLS][N_FFT + CP_LEN],
                              int total_frame_samples) {
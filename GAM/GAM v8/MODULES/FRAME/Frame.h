@@ -11,11 +11,54 @@ float calculate_correlation(const float complex received_signal[], int start_ind
 
 bool detect_frame_start(const float complex received_signal[], int length, int *frame_start_index);
 
+// Etapa 1 de la adquisición: mejores desplazamientos por correlación de signos (XOR + popcount)
+bool find_coarse_preamble_candidates(const float complex received_signal[], int length,
+                                     int candidate_index[COARSE_CANDIDATES], int *num_candidates);
+
+bool detect_frame_start_two_stage(const float complex received_signal[], int length, int *frame_start_index);
+
+bool detect_frame_start_schmidl_cox(const float complex received_signal[], int length, SchmidlCoxResult *result);
+
+void correct_cfo_time_domain(float complex signal[], int length, float cfo);
+
+bool init_cfo_bank_detector(CFOBankDetector *detector);
+
+void free_cfo_bank_detector(CFOBankDetector *detector);
+
+bool detect_frame_start_cfo_bank(CFOBankDetector *detector, const float complex received_signal[], int length,
+                                 CFOBankResult *result);
+
+bool init_preamble_correlator(PreambleCorrelator *correlator);
+
+void reset_preamble_correlator(PreambleCorrelator *correlator, const float complex received_signal[],
+                               int start_index);
+
+float preamble_correlator_next(PreambleCorrelator *correlator, const float complex received_signal[], int length);
+
+
+// Búsqueda de todos los preámbulos en capturas largas (overlap-save en frecuencia)
+bool init_overlap_save_correlator(OverlapSaveCorrelator *correlator, int block_size);
+
+void free_overlap_save_correlator(OverlapSaveCorrelator *correlator);
+
+bool find_preambles_overlap_save(OverlapSaveCorrelator *correlator, const float complex received_signal[],
+                                 int length, float threshold, int min_distance,
+                                 PreamblePeak peaks[], int max_peaks, int *num_peaks);
+
 
 // Formación de trama
 bool add_preamble_to_prb_frame(const float complex ofdm_symbols_with_cp[PRB_SYMBOLS][N_FFT + CP_LEN],
                                float complex frame_with_preamble[PREAMBLE_LEN + PRB_SYMBOLS * (N_FFT + CP_LEN)]);
 
+// Constructor de trama sin copias: la IFFT escribe directamente en su hueco
+bool init_frame_builder(FrameBuilder *builder, float complex frame[], int frame_length);
+
+bool init_superframe_builder(FrameBuilder *builder, float complex frame[], int frame_length, int num_prbs);
+
+float complex *frame_symbol_slot(const FrameBuilder *builder, int sym);
+
+bool commit_frame_symbol(FrameBuilder *builder, int sym);
+
 bool extract_ofdm_from_frame(const float complex frame_with_preamble[], int frame_start_index,
                              float complex ofdm_symbols_with_cp[PRB_SYMBOLS][N_FFT + CP_LEN], int total_frame_samples);
 
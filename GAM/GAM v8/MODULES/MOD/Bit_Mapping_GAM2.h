@@ -1,11 +0,0 @@
-#ifndef GAM_BIT_MAPPING_GAM2_H
-#define GAM_BIT_MAPPING_GAM2_H
-
-static const int BIT_MAPPING[4][2] = {
-        {0, 0},  // Índice 0
-        {0, 1},  // Índice 1
-        {1, 1},  // Índice 2
-        {1, 0}   // Índice 3
-};
-
-#endif //GAM_BIT_MAPPING_GAM2_H
@@ -1,15 +0,0 @@
-#ifndef GAM_BIT_MAPPING_GAM3_H
-#define GAM_BIT_MAPPING_GAM3_H
-
-static const int BIT_MAPPING[8][3] = {
-        {0, 0, 0},  // Índice 0
-        {0, 0, 1},  // Índice 1
-        {0, 1, 1},  // Índice 2
-        {0, 1, 0},  // Índice 3
-        {1, 1, 0},  // Índice 4
-        {1, 1, 1},  // Índice 5
-        {1, 0, 1},  // Índice 6
-        {1, 0, 0}   // Índice 7
-};
-
-#endif //GAM_BIT_MAPPING_GAM3_H
@@ -1,45 +1,292 @@
 #include "Mod.h"
 
-// Selección automática del archivo de mapeo según BPS
-#if BPS == 2
-#include "Bit_Mapping_GAM2.h"
-#elif BPS == 3
-#include "Bit_Mapping_GAM3.h"
-#elif BPS == 4
-    #include "Bit_Mapping_GAM4.h"
+// Espiral dorada sin normalizar de MAX_C_POINTS puntos: cada orden usa su prefijo (trigonometría una sola vez)
+static float complex *volatile spiral_points;
+
+// Constelaciones por orden (bits por símbolo), construidas en la primera petición de cada orden
+static GAMConstellation *volatile constellation_cache[MAX_BPS + 1];
+
+// FUNCIONES MODULACIÓN
+// Lectura con barrera de un puntero publicado por comparación-intercambio (intercambio nulo si sigue vacío)
+static inline void *read_published(void *volatile *slot)
+{
+    return InterlockedCompareExchangePointer((PVOID volatile *)slot, NULL, NULL);
+}
+
+static float complex golden_spiral_point(int i)
+{
+    // Patrón espiral dorado
+    float angle = (i + 1) * ANGLE_STEP;
+    float radius = sqrtf(i + 1);
+    return radius * (cosf(angle) + sinf(angle)*I);
+}
+
+// Publicación única: si otro hilo la publica antes, se descarta la copia propia
+static const float complex *get_golden_spiral(void)
+{
+    float complex *spiral = read_published((void *volatile *)&spiral_points);
+    if (spiral) return spiral;
+
+    spiral = malloc(MAX_C_POINTS * sizeof(float complex));
+    if (!spiral)
+    {
+        printf("Error: Sin memoria para la espiral dorada\n");
+        return NULL;
+    }
+
+    for (int i = 0; i < MAX_C_POINTS; i++) {   spiral[i] = golden_spiral_point(i);   }
+
+    float complex *published = InterlockedCompareExchangePointer((PVOID volatile *)&spiral_points, spiral, NULL);
+    if (published)
+    {
+        free(spiral);
+        return published;
+    }
+
+    return spiral;
+}
+
+// ETIQUETADO DE ÓRDENES ALTOS
+// Los vecinos de un punto de la espiral dorada están a distancias de índice de Fibonacci (parastichias), no en
+// índices consecutivos (~137 grados de separación): un Gray sobre el índice cuesta ~bps/2 bits por vecino
+static inline int label_distance(int a, int b)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount((unsigned)(a ^ b));
 #else
-    #error "BPS no soportado. Use BPS = 2, 3 o 4"
+    int x = a ^ b, count = 0;
+    while (x) { x &= x - 1; count++; }
+    return count;
 #endif
+}
 
-// FUNCIONES MODULACIÓN
-bool init_golden_modulation(Constellation constellation[C_POINTS])
+// Distancia^2 entre los puntos i y j de la espiral sin normalizar, en double desde los índices
+static double spiral_distance2(int i, int j)
+{
+    double ri = i + 1.0, rj = j + 1.0;
+    return ri + rj - 2.0 * sqrt(ri * rj) * cos((double)(j - i) * ANGLE_STEP);
+}
+
+// Candidatos a vecino de i: distancias de índice de Fibonacci a ambos lados
+static int fibonacci_candidates(int i, int num_points, int candidates[LABEL_MAX_CANDIDATES])
 {
-    if (C_POINTS != (1 << BPS)) {
-        return true; // Error: C_POINTS debe ser 2^BPS
+    int count = 0;
+    for (int f0 = 1, f1 = 2; f0 < num_points; f1 += f0, f0 = f1 - f0)
+    {
+        if (i - f0 >= 0) candidates[count++] = i - f0;
+        if (i + f0 < num_points) candidates[count++] = i + f0;
     }
+    return count;
+}
+
+static void find_label_neighbours(int num_points, LabelNeighbours neighbours[])
+{
+    int candidates[LABEL_MAX_CANDIDATES];
+
+    for (int i = 0; i < num_points; i++)
+    {
+        int count = fibonacci_candidates(i, num_points, candidates);
+        neighbours[i].minimum_distance2 = DBL_MAX;
+        for (int c = 0; c < count; c++)
+        {
+            double distance2 = spiral_distance2(i, candidates[c]);
+            if (distance2 < neighbours[i].minimum_distance2) neighbours[i].minimum_distance2 = distance2;
+        }
+    }
+
+    // Misma referencia y peso en los dos extremos: la relación es simétrica y el coste de un intercambio, exacto
+    for (int i = 0; i < num_points; i++)
+    {
+        int count = fibonacci_candidates(i, num_points, candidates);
+        LabelNeighbours *list = &neighbours[i];
+        double ratio[LABEL_NEIGHBOURS];
+        list->count = 0;
+
+        for (int c = 0; c < count; c++)
+        {
+            int j = candidates[c];
+            double reference = fmin(list->minimum_distance2, neighbours[j].minimum_distance2);
+            double r = spiral_distance2(i, j) / reference;
+            if (r > LABEL_NEIGHBOUR_RADIUS * LABEL_NEIGHBOUR_RADIUS) continue;
 
+            // Inserción ordenada por cercanía relativa (se descarta el más lejano si la lista está llena)
+            int pos = list->count < LABEL_NEIGHBOURS ? list->count++ : LABEL_NEIGHBOURS;
+            for (; pos > 0 && ratio[pos - 1] > r; pos--)
+            {
+                if (pos < LABEL_NEIGHBOURS) { list->index[pos] = list->index[pos - 1]; ratio[pos] = ratio[pos - 1]; }
+            }
+            if (pos < LABEL_NEIGHBOURS) { list->index[pos] = j; ratio[pos] = r; }
+        }
+
+        for (int k = 0; k < list->count; k++)
+        {
+            long weight = lround(LABEL_WEIGHT_SCALE * exp(-LABEL_WEIGHT_DECAY * (ratio[k] - 1.0)));
+            list->weight[k] = weight > 0 ? (int)weight : 1;
+        }
+    }
+}
+
+// Bits distintos con los vecinos ya etiquetados (etiqueta < 0: sin asignar), ponderados por cercanía
+static int label_cost(const LabelNeighbours *neighbours, const int labels[], int label)
+{
+    int cost = 0;
+    for (int k = 0; k < neighbours->count; k++)
+    {
+        int other = labels[neighbours->index[k]];
+        if (other >= 0) cost += neighbours->weight[k] * label_distance(label, other);
+    }
+    return cost;
+}
+
+// Del centro hacia fuera, cada punto toma la etiqueta libre más barata a un bit de algún vecino etiquetado;
+// después se intercambian etiquetas mientras baje el coste de la pareja
+static bool generate_neighbour_labels(int num_points, int bits_per_symbol, int labels[])
+{
+    LabelNeighbours *neighbours = malloc((size_t)num_points * sizeof(LabelNeighbours));
+    int *index_of_label = malloc((size_t)num_points * sizeof(int));
+    if (!neighbours || !index_of_label)
+    {
+        printf("Error: Sin memoria para el etiquetado de %d puntos\n", num_points);
+        free(neighbours);
+        free(index_of_label);
+        return true;
+    }
+
+    find_label_neighbours(num_points, neighbours);
+
+    for (int i = 0; i < num_points; i++) {   labels[i] = -1; index_of_label[i] = -1;   }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        int best_label = -1, best_cost = 0;
+        for (int k = 0; k < neighbours[i].count; k++)
+        {
+            int other = labels[neighbours[i].index[k]];
+            if (other < 0) continue;
+
+            for (int bit = 0; bit < bits_per_symbol; bit++)
+            {
+                int candidate = other ^ (1 << bit);
+                if (index_of_label[candidate] >= 0) continue;
+
+                int cost = label_cost(&neighbours[i], labels, candidate);
+                if (best_label < 0 || cost < best_cost) { best_label = candidate; best_cost = cost; }
+            }
+        }
+
+        // Sin etiquetas libres a un bit de los vecinos (o sin vecinos etiquetados): la libre más barata
+        if (best_label < 0)
+        {
+            for (int candidate = 0; candidate < num_points; candidate++)
+            {
+                if (index_of_label[candidate] >= 0) continue;
+
+                int cost = label_cost(&neighbours[i], labels, candidate);
+                if (best_label < 0 || cost < best_cost) { best_label = candidate; best_cost = cost; }
+            }
+        }
+
+        labels[i] = best_label;
+        index_of_label[best_label] = i;
+    }
+
+    for (int pass = 0; pass < LABEL_MAX_PASSES; pass++)
+    {
+        bool improved = false;
+        for (int p = 0; p < num_points; p++)
+        {
+            // Solo un intercambio con p cambia su coste
+            int cost_p = label_cost(&neighbours[p], labels, labels[p]);
+            for (int k = 0; k < neighbours[p].count; k++)
+            {
+                for (int bit = 0; bit < bits_per_symbol; bit++)
+                {
+                    int q = index_of_label[labels[neighbours[p].index[k]] ^ (1 << bit)];
+                    if (q == p) continue;
+
+                    int label_p = labels[p], label_q = labels[q];
+                    int before = cost_p + label_cost(&neighbours[q], labels, label_q);
+                    labels[p] = label_q;
+                    labels[q] = label_p;
+                    int after_p = label_cost(&neighbours[p], labels, label_q);
+                    int after = after_p + label_cost(&neighbours[q], labels, label_p);
+
+                    if (after < before)
+                    {
+                        index_of_label[label_q] = p;
+                        index_of_label[label_p] = q;
+                        cost_p = after_p;
+                        improved = true;
+                    }
+                    else
+                    {
+                        labels[p] = label_p;
+                        labels[q] = label_q;
+                    }
+                }
+            }
+        }
+        if (!improved) break;
+    }
+
+    free(neighbours);
+    free(index_of_label);
+
+    return false;
+}
+
+// Hasta GRAY_INDEX_MAX_BPS, Gray sobre el índice de la espiral (reproduce las tablas de mapeo de 2-4 bits);
+// en órdenes mayores, etiquetas a pocos bits de los vecinos geométricos (generate_neighbour_labels)
+bool init_golden_modulation(Constellation constellation[], int bits_per_symbol)
+{
+    if (!constellation || bits_per_symbol < MIN_BPS || bits_per_symbol > MAX_BPS)
+    {
+        printf("Error: Orden de modulacion no soportado (%d bits por simbolo, rango %d-%d)\n",
+               bits_per_symbol, MIN_BPS, MAX_BPS);
+        return true;
+    }
+
+    const float complex *spiral = get_golden_spiral();
+    if (!spiral) return true;
+
+    int num_points = 1 << bits_per_symbol;
     float total_power = 0.0f;
 
-    for (int i = 0; i < C_POINTS; i++)
+    int *labels = NULL;
+    if (bits_per_symbol > GRAY_INDEX_MAX_BPS)
     {
-        // Patrón espiral dorado
-        float angle = (i + 1) * ANGLE_STEP;
-        float radius = sqrtf(i + 1);
-        constellation[i].point = radius * (cosf(angle) + sinf(angle)*I);
+        labels = malloc((size_t)num_points * sizeof(int));
+        if (!labels)
+        {
+            printf("Error: Sin memoria para el etiquetado de %d puntos\n", num_points);
+            return true;
+        }
+        if (generate_neighbour_labels(num_points, bits_per_symbol, labels))
+        {
+            free(labels);
+            return true;
+        }
+    }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        constellation[i].point = spiral[i];
         total_power += crealf(constellation[i].point) * crealf(constellation[i].point) +
                        cimagf(constellation[i].point) * cimagf(constellation[i].point);
 
-        // Asignación de bits desde el mapping predefinido
-        for (int bit_pos = 0; bit_pos < BPS; bit_pos++)
+        int label = labels ? labels[i] : (i ^ (i >> 1));
+        for (int bit_pos = 0; bit_pos < bits_per_symbol; bit_pos++)
         {
-            constellation[i].bits[bit_pos] = BIT_MAPPING[i][bit_pos];
+            constellation[i].bits[bit_pos] = (label >> (bits_per_symbol - 1 - bit_pos)) & 1;
         }
     }
 
+    free(labels);
+
     // Normalización de potencia
-    float norm_factor = sqrtf(total_power / C_POINTS);
+    float norm_factor = sqrtf(total_power / num_points);
 
-    for (int i = 0; i < C_POINTS; i++)
+    for (int i = 0; i < num_points; i++)
     {
         constellation[i].point /= norm_factor;
     }
@@ -47,51 +294,500 @@ bool init_golden_modulation(Constellation constellation[C_POINTS])
     return false;
 }
 
-bool golden_modulation_hard(const int interleaved_bits[TOTAL_BITS_REPEATED], float complex symbols[TOTAL_SYMBOLS])
+static void build_decision_grid(GAMConstellation *constellation);
+static bool build_spatial_index(GAMConstellation *constellation);
+
+bool init_gam_constellation(GAMConstellation *constellation, int bits_per_symbol)
+{
+    if (!constellation || init_golden_modulation(constellation->points, bits_per_symbol)) return true;
+
+    int num_points = 1 << bits_per_symbol;
+    constellation->bits_per_symbol = bits_per_symbol;
+    constellation->num_points = num_points;
+    constellation->symbols_per_block = (TOTAL_BITS_REPEATED + bits_per_symbol - 1) / bits_per_symbol;
+
+    if (constellation->symbols_per_block > DATA_RE_PER_PRB)
+    {
+        printf("Error: Demasiados simbolos (%d) para REs disponibles (%d)\n",
+               constellation->symbols_per_block, DATA_RE_PER_PRB);
+        return true;
+    }
+
+    for (int label = 0; label < num_points; label++) {   constellation->index_of_label[label] = -1;   }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        int label = 0;
+        for (int k = 0; k < bits_per_symbol; k++)
+        {
+            label = (label << 1) | (constellation->points[i].bits[k] & 1);
+        }
+
+        if (constellation->index_of_label[label] != -1)
+        {
+            printf("Error: Etiqueta %d repetida en el mapeo de bits\n", label);
+            return true;
+        }
+
+        constellation->label_of_index[i] = label;
+        constellation->index_of_label[label] = i;
+        constellation->label_to_point[label] = constellation->points[i].point;
+        constellation->point_re[i] = crealf(constellation->points[i].point);
+        constellation->point_im[i] = cimagf(constellation->points[i].point);
+    }
+
+    build_decision_grid(constellation);
+    if (build_spatial_index(constellation)) return true;
+    constellation->initialized = true;
+
+    return false;
+}
+
+// Caché por orden: el primer hilo que pide un orden lo construye y lo publica con una comparación-intercambio
+// (si otro se adelanta, se descarta la copia propia); después es de solo lectura y se comparte entre hilos
+const GAMConstellation *get_gam_constellation(int bits_per_symbol)
+{
+    if (bits_per_symbol < MIN_BPS || bits_per_symbol > MAX_BPS)
+    {
+        printf("Error: Orden de modulacion no soportado (%d bits por simbolo, rango %d-%d)\n",
+               bits_per_symbol, MIN_BPS, MAX_BPS);
+        return NULL;
+    }
+
+    GAMConstellation *constellation = read_published((void *volatile *)&constellation_cache[bits_per_symbol]);
+    if (constellation) return constellation;
+
+    constellation = malloc(sizeof(GAMConstellation));
+    if (!constellation)
+    {
+        printf("Error: Sin memoria para la constelacion de %d bits por simbolo\n", bits_per_symbol);
+        return NULL;
+    }
+
+    if (init_gam_constellation(constellation, bits_per_symbol))
+    {
+        free(constellation);
+        return NULL;
+    }
+
+    GAMConstellation *published = InterlockedCompareExchangePointer(
+        (PVOID volatile *)&constellation_cache[bits_per_symbol], constellation, NULL);
+    if (published)
+    {
+        free(constellation);
+        return published;
+    }
+
+    return constellation;
+}
+
+const GAMConstellation *default_gam_constellation(void)
+{
+    return get_gam_constellation(DEFAULT_BPS);
+}
+
+void free_gam_constellations(void)
+{
+    for (int bits_per_symbol = 0; bits_per_symbol <= MAX_BPS; bits_per_symbol++)
+    {
+        free(constellation_cache[bits_per_symbol]);
+        constellation_cache[bits_per_symbol] = NULL;
+    }
+
+    free(spiral_points);
+    spiral_points = NULL;
+}
+
+bool gam_modulate(const GAMConstellation *constellation, const int bits[], int num_symbols,
+                  float complex symbols[])
+{
+    if (!constellation || !constellation->initialized || !bits || !symbols || num_symbols < 0)
+    {
+        printf("Error: Constelacion no inicializada para modulacion\n");
+        return true;
+    }
+
+    const int bits_per_symbol = constellation->bits_per_symbol;
+
+    for (int i = 0; i < num_symbols; i++)
+    {
+        const int *symbol_bits = &bits[i * bits_per_symbol];
+        int label = 0;
+        for (int k = 0; k < bits_per_symbol; k++) {   label = (label << 1) | (symbol_bits[k] & 1);   }
+
+        symbols[i] = constellation->label_to_point[label];
+    }
+
+    return false;
+}
+
+bool gam_modulate_packed(const GAMConstellation *constellation, const uint8_t packed_bits[], int num_symbols,
+                         float complex symbols[])
+{
+    if (!constellation || !constellation->initialized || !packed_bits || !symbols || num_symbols < 0)
+    {
+        printf("Error: Constelacion no inicializada para modulacion\n");
+        return true;
+    }
+
+    // Acumulador de bits: se cargan bytes según se necesitan, la etiqueta son los bits_per_symbol más antiguos
+    const int bits_per_symbol = constellation->bits_per_symbol;
+    uint32_t accumulator = 0;
+    int available = 0;
+    int byte_index = 0;
+
+    for (int i = 0; i < num_symbols; i++)
+    {
+        while (available < bits_per_symbol)
+        {
+            accumulator = (accumulator << 8) | packed_bits[byte_index++];
+            available += 8;
+        }
+
+        available -= bits_per_symbol;
+        symbols[i] = constellation->label_to_point[(accumulator >> available) & (constellation->num_points - 1)];
+    }
+
+    return false;
+}
+
+// Bloque de transporte completo: si el orden no divide TOTAL_BITS_REPEATED el último símbolo lleva ceros
+bool gam_modulate_block(const GAMConstellation *constellation, const int interleaved_bits[TOTAL_BITS_REPEATED],
+                        float complex symbols[MAX_BLOCK_SYMBOLS])
+{
+    if (!constellation || !constellation->initialized || !interleaved_bits)
+    {
+        printf("Error: Constelacion no inicializada para modulacion\n");
+        return true;
+    }
+
+    int padded_bits[MAX_BLOCK_BITS];
+    int num_bits = constellation->symbols_per_block * constellation->bits_per_symbol;
+    for (int i = 0; i < num_bits; i++) {   padded_bits[i] = (i < TOTAL_BITS_REPEATED) ? interleaved_bits[i] : 0;   }
+
+    return gam_modulate(constellation, padded_bits, constellation->symbols_per_block, symbols);
+}
+
+bool golden_modulation_hard(const int interleaved_bits[TOTAL_BITS_REPEATED], float complex symbols[MAX_BLOCK_SYMBOLS])
+{
+    return gam_modulate_block(default_gam_constellation(), interleaved_bits, symbols);
+}
+
+// FUNCIONES DEMODULACIÓN
+// Un punto j solo puede ganar dentro de la celda si su distancia mínima a la celda no supera la menor
+// distancia máxima de algún punto a la celda. La lista resultante es un superconjunto de los ganadores.
+static void build_decision_grid(GAMConstellation *constellation)
+{
+    const int num_points = constellation->num_points;
+    float max_radius = 0.0f;
+    for (int i = 0; i < num_points; i++)
+    {
+        float radius = cabsf(constellation->points[i].point);
+        if (radius > max_radius) max_radius = radius;
+    }
+
+    float half_span = DECISION_GRID_EXTENT * max_radius;
+    float cell = 2.0f * half_span / DECISION_GRID_SIZE;
+    constellation->grid_origin = -half_span;
+    constellation->grid_inverse_cell = 1.0f / cell;
+
+    // Margen frente al redondeo del cálculo de celda en la decisión
+    const float margin = 1e-3f * cell;
+
+    for (int row = 0; row < DECISION_GRID_SIZE; row++)
+    {
+        for (int col = 0; col < DECISION_GRID_SIZE; col++)
+        {
+            float x0 = -half_span + col * cell - margin, x1 = x0 + cell + 2.0f * margin;
+            float y0 = -half_span + row * cell - margin, y1 = y0 + cell + 2.0f * margin;
+            float min_dist[MAX_C_POINTS];
+            float best_max_dist = FLT_MAX;
+
+            for (int i = 0; i < num_points; i++)
+            {
+                float px = crealf(constellation->points[i].point), py = cimagf(constellation->points[i].point);
+                float dx_min = (px < x0) ? x0 - px : (px > x1) ? px - x1 : 0.0f;
+                float dy_min = (py < y0) ? y0 - py : (py > y1) ? py - y1 : 0.0f;
+                float dx_max = fmaxf(fabsf(px - x0), fabsf(px - x1));
+                float dy_max = fmaxf(fabsf(py - y0), fabsf(py - y1));
+
+                min_dist[i] = dx_min * dx_min + dy_min * dy_min;
+                float max_dist = dx_max * dx_max + dy_max * dy_max;
+                if (max_dist < best_max_dist) best_max_dist = max_dist;
+            }
+
+            int cell_index = row * DECISION_GRID_SIZE + col;
+            int count = 0;
+            for (int i = 0; i < num_points; i++)
+            {
+                if (min_dist[i] > best_max_dist) continue;
+                if (count < DECISION_GRID_MAX_CANDIDATES) constellation->grid_candidates[cell_index][count] = (uint16_t)i;
+                count++;
+            }
+
+            // Demasiados candidatos: la celda se resuelve con la búsqueda exhaustiva
+            constellation->grid_count[cell_index] = (count <= DECISION_GRID_MAX_CANDIDATES) ? (uint8_t)count : 0;
+        }
+    }
+}
+
+// FUNCIONES ÍNDICE ESPACIAL
+static float polar_angle(float re, float im)
+{
+    float angle = atan2f(im, re);
+    return (angle < 0.0f) ? angle + 2.0f * (float)M_PI : angle;
+}
+
+static int spatial_ring(const GAMConstellation *constellation, float radius)
+{
+    int ring = (int)(radius * constellation->spatial_inverse_ring_width);
+    return (ring < constellation->spatial_rings) ? ring : constellation->spatial_rings - 1;
+}
+
+static int spatial_sector(int sectors, float angle)
+{
+    int sector = (int)(angle * sectors * (float)(0.5 / M_PI));
+    return (sector < sectors) ? sector : sectors - 1;
+}
+
+// Anillos de grosor fijo (radio máximo / anillos) con ceil(2pi (k + 1/2)) sectores: celdas casi cuadradas
+static bool build_spatial_index(GAMConstellation *constellation)
 {
-    Constellation temp_const[C_POINTS];
+    const int num_points = constellation->num_points;
+    float max_radius = 0.0f;
+    for (int i = 0; i < num_points; i++)
+    {
+        float radius = cabsf(constellation->points[i].point);
+        if (radius > max_radius) max_radius = radius;
+    }
 
-    if (init_golden_modulation(temp_const)) return true;
+    // Área pi R^2 repartida en celdas de SPATIAL_POINTS_PER_CELL puntos de media
+    int rings = (int)ceilf(sqrtf((float)num_points / (SPATIAL_POINTS_PER_CELL * (float)M_PI)));
+    if (rings < 1) rings = 1;
+    if (rings > SPATIAL_MAX_RINGS)
+    {
+        printf("Error: Demasiados anillos para el indice espacial (%d)\n", rings);
+        return true;
+    }
+
+    constellation->spatial_rings = rings;
+    constellation->spatial_ring_width = max_radius / rings;
+    constellation->spatial_inverse_ring_width = rings / max_radius;
+    constellation->use_spatial_index = (num_points >= SPATIAL_INDEX_MIN_POINTS);
 
-    for (int i = 0; i < TOTAL_SYMBOLS; i++)
+    int cells = 0;
+    for (int ring = 0; ring < rings; ring++)
     {
-        int start_bit_index = i * BPS;
-        bool found = false;
+        int sectors = (int)ceilf(2.0f * (float)M_PI * (ring + 0.5f));
+        if (cells + sectors > SPATIAL_MAX_CELLS)
+        {
+            printf("Error: Demasiadas celdas para el indice espacial\n");
+            return true;
+        }
 
-        // Buscar el símbolo que coincide con los bits
-        for (int j = 0; j < C_POINTS; j++)
+        constellation->ring_sectors[ring] = sectors;
+        constellation->ring_first_cell[ring] = cells;
+        for (int d = 0; d < sectors; d++)
         {
-            bool match = true;
-            for (int k = 0; k < BPS; k++)
+            constellation->sector_cos[cells + d] = cosf(2.0f * (float)M_PI * d / sectors);
+            constellation->sector_sin[cells + d] = sinf(2.0f * (float)M_PI * d / sectors);
+        }
+        cells += sectors;
+    }
+    constellation->ring_first_cell[rings] = cells;
+
+    // Reparto por conteo: los puntos de cada celda quedan contiguos y en orden de índice
+    int point_cell[MAX_C_POINTS];
+    int next_slot[SPATIAL_MAX_CELLS];
+    for (int c = 0; c <= cells; c++) {   constellation->cell_start[c] = 0;   }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        float re = constellation->point_re[i], im = constellation->point_im[i];
+        int ring = spatial_ring(constellation, sqrtf(re * re + im * im));
+        point_cell[i] = constellation->ring_first_cell[ring] +
+                        spatial_sector(constellation->ring_sectors[ring], polar_angle(re, im));
+        constellation->cell_start[point_cell[i] + 1]++;
+    }
+
+    for (int c = 0; c < cells; c++)
+    {
+        constellation->cell_start[c + 1] += constellation->cell_start[c];
+        next_slot[c] = constellation->cell_start[c];
+    }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        int slot = next_slot[point_cell[i]]++;
+        constellation->cell_index[slot] = (uint16_t)i;
+        constellation->cell_label[slot] = (uint16_t)constellation->label_of_index[i];
+        constellation->cell_re[slot] = constellation->point_re[i];
+        constellation->cell_im[slot] = constellation->point_im[i];
+    }
+
+    return false;
+}
+
+static void spatial_visit_cell(const GAMConstellation *constellation, int cell, SpatialQuery *query)
+{
+    const int bits_per_symbol = query->bits_per_symbol;
+
+    for (int slot = constellation->cell_start[cell]; slot < constellation->cell_start[cell + 1]; slot++)
+    {
+        float dx = query->y_re - constellation->cell_re[slot], dy = query->y_im - constellation->cell_im[slot];
+        float dist = dx * dx + dy * dy;
+
+        if (query->nearest)
+        {
+            // Mismo desempate que la búsqueda exhaustiva: a igual distancia gana el índice menor
+            int index = constellation->cell_index[slot];
+            if (dist < query->bound || (dist == query->bound && index < query->best_index))
+            {
+                query->bound = dist;
+                query->best_index = index;
+            }
+        }
+        else if (dist <= query->bound)
+        {
+            // Nueva distancia mínima: se estrecha la cota y se reescalan las sumas (log-sum-exp en una pasada)
+            if (dist < query->reference)
             {
-                if (temp_const[j].bits[k] != interleaved_bits[start_bit_index + k])
+                if (query->exact)
                 {
-                    match = false;
-                    break;
+                    float scale = expf(-(query->reference - dist) * query->inverse_variance);
+                    for (int k = 0; k < bits_per_symbol; k++)
+                    {
+                        query->sum[0][k] *= scale;
+                        query->sum[1][k] *= scale;
+                    }
                 }
+                query->reference = dist;
+                query->bound = dist + query->margin;
+            }
+
+            int label = constellation->cell_label[slot];
+            for (int k = 0; k < bits_per_symbol; k++)
+            {
+                float *minimum = &query->minimum[(label >> (bits_per_symbol - 1 - k)) & 1][k];
+                *minimum = (dist < *minimum) ? dist : *minimum;
             }
 
-            if (match)
+            if (query->exact)
             {
-                symbols[i] = temp_const[j].point;
-                found = true;
-                break;
+                float weight = expf(-(dist - query->reference) * query->inverse_variance);
+                for (int k = 0; k < bits_per_symbol; k++)
+                {
+                    query->sum[(label >> (bits_per_symbol - 1 - k)) & 1][k] += weight;
+                }
             }
         }
+    }
+}
+
+// Cota inferior exacta de |y - p|^2 para p con radio en [inner, outer] y separación angular >= gap:
+// |y - p|^2 = (rho - r cos(gap))^2 + (r sin(gap))^2, creciente con la separación
+static float ring_lower_bound(const SpatialQuery *query, float inner, float outer, float gap_cos, float gap_sin)
+{
+    float projection = query->radius * gap_cos;
+    float rho = (projection < inner) ? inner : (projection > outer) ? outer : projection;
+    float along = rho - projection, across = query->radius * gap_sin;
 
-        if (!found) return true;
+    return along * along + across * across;
+}
+
+static void spatial_visit_ring(const GAMConstellation *constellation, int ring, SpatialQuery *query)
+{
+    float inner = ring * constellation->spatial_ring_width;
+    float outer = inner + constellation->spatial_ring_width;
+    int sectors = constellation->ring_sectors[ring];
+    int first = constellation->ring_first_cell[ring];
+    int home = spatial_sector(sectors, query->angle);
+
+    spatial_visit_cell(constellation, first + home, query);
+
+    // Sectores a d pasos a ambos lados: separación angular de al menos (d - 1) anchos
+    for (int d = 1; 2 * d <= sectors; d++)
+    {
+        float lower_bound = ring_lower_bound(query, inner, outer, constellation->sector_cos[first + d - 1],
+                                             constellation->sector_sin[first + d - 1]);
+        if (lower_bound * SPATIAL_BOUND_SLACK > query->bound) break;
+
+        int right = (home + d < sectors) ? home + d : home + d - sectors;
+        int left = (home - d >= 0) ? home - d : home - d + sectors;
+        spatial_visit_cell(constellation, first + right, query);
+        if (left != right) spatial_visit_cell(constellation, first + left, query);
     }
+}
+
+// Anillo propio y luego hacia fuera y hacia dentro alternando, mientras el hueco radial no supere la cota
+static void spatial_search(const GAMConstellation *constellation, SpatialQuery *query)
+{
+    int home = spatial_ring(constellation, query->radius);
+    bool outward = true, inward = true;
+
+    spatial_visit_ring(constellation, home, query);
+
+    for (int step = 1; outward || inward; step++)
+    {
+        if (outward)
+        {
+            int ring = home + step;
+            float gap = ring * constellation->spatial_ring_width - query->radius;
+            outward = ring < constellation->spatial_rings &&
+                      !(gap > 0.0f && gap * gap * SPATIAL_BOUND_SLACK > query->bound);
+            if (outward) spatial_visit_ring(constellation, ring, query);
+        }
+
+        if (inward)
+        {
+            int ring = home - step;
+            float gap = query->radius - (ring + 1) * constellation->spatial_ring_width;
+            inward = ring >= 0 && !(gap > 0.0f && gap * gap * SPATIAL_BOUND_SLACK > query->bound);
+            if (inward) spatial_visit_ring(constellation, ring, query);
+        }
+    }
+}
+
+// Error si el símbolo no es finito
+static bool init_spatial_query(const GAMConstellation *constellation, SpatialQuery *query, float complex symbol,
+                               bool nearest)
+{
+    query->y_re = crealf(symbol);
+    query->y_im = cimagf(symbol);
+    query->radius = sqrtf(query->y_re * query->y_re + query->y_im * query->y_im);
+    if (!(query->radius <= FLT_MAX)) return true;
+
+    query->angle = polar_angle(query->y_re, query->y_im);
+    query->bound = FLT_MAX;
+    query->nearest = nearest;
+    query->best_index = -1;
+    query->reference = FLT_MAX;
+    query->bits_per_symbol = constellation->bits_per_symbol;
 
     return false;
 }
 
-// FUNCIONES DEMODULACIÓN
-int calculate_min_distance_hard(float complex symbol, Constellation constellation[C_POINTS])
+// Búsqueda completa: índice espacial en órdenes altos, exhaustiva en los bajos
+static int nearest_point(const GAMConstellation *constellation, float complex symbol)
+{
+    if (!constellation->use_spatial_index)
+    {
+        return calculate_min_distance_hard(symbol, constellation->points, constellation->num_points);
+    }
+
+    SpatialQuery query;
+    if (init_spatial_query(constellation, &query, symbol, true)) return -1;
+    spatial_search(constellation, &query);
+
+    return query.best_index;
+}
+
+int calculate_min_distance_hard(float complex symbol, const Constellation constellation[], int num_points)
 {
     float min_dist = FLT_MAX;
     int best_index = -1;
 
-    for (int i = 0; i < C_POINTS; i++)
+    for (int i = 0; i < num_points; i++)
     {
         float complex diff = symbol - constellation[i].point;
         float dist = crealf(diff * conjf(diff));
@@ -106,24 +802,254 @@ int calculate_min_distance_hard(float complex symbol, Constellation constellatio
     return best_index;
 }
 
-bool golden_demodulation_hard(float complex symbols[TOTAL_SYMBOLS], Constellation constellation[C_POINTS],
-                              int interleaved_bits[TOTAL_BITS_REPEATED])
+bool golden_demodulation_hard(const float complex symbols[MAX_BLOCK_SYMBOLS], const GAMConstellation *constellation,
+                              int interleaved_bits[MAX_BLOCK_BITS])
 {
+    if (!constellation || !constellation->initialized) return true;
+
     int index, bit_index = 0;
+    const int bits_per_symbol = constellation->bits_per_symbol;
 
-    for (int i = 0; i < TOTAL_SYMBOLS; i++)
+    for (int i = 0; i < constellation->symbols_per_block; i++)
     {
-        index = calculate_min_distance_hard(symbols[i], constellation);
+        index = calculate_min_distance_hard(symbols[i], constellation->points, constellation->num_points);
 
         if (index == -1) return true;
 
         // Copiar los bits del símbolo detectado
-        for (int j = 0; j < BPS; j++)
+        for (int j = 0; j < bits_per_symbol; j++)
         {
-            interleaved_bits[bit_index + j] = constellation[index].bits[j];
+            interleaved_bits[bit_index + j] = constellation->points[index].bits[j];
         }
-        bit_index += BPS;
+        bit_index += bits_per_symbol;
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+int gam_decide_hard(const GAMConstellation *constellation, float complex symbol)
+{
+    float fx = (crealf(symbol) - constellation->grid_origin) * constellation->grid_inverse_cell;
+    float fy = (cimagf(symbol) - constellation->grid_origin) * constellation->grid_inverse_cell;
+
+    // Fuera de la rejilla (o NaN): búsqueda completa
+    if (!(fx >= 0.0f && fx < DECISION_GRID_SIZE && fy >= 0.0f && fy < DECISION_GRID_SIZE))
+    {
+        return nearest_point(constellation, symbol);
+    }
+
+    int cell_index = (int)fy * DECISION_GRID_SIZE + (int)fx;
+    int count = constellation->grid_count[cell_index];
+    const uint16_t *candidates = constellation->grid_candidates[cell_index];
+
+    if (count == 1) return candidates[0];
+    if (count == 0) return nearest_point(constellation, symbol);
+
+    // Candidatos en orden de índice y comparación estricta: mismo desempate que la búsqueda exhaustiva
+    float min_dist = FLT_MAX;
+    int best_index = -1;
+    for (int c = 0; c < count; c++)
+    {
+        float complex diff = symbol - constellation->points[candidates[c]].point;
+        float dist = crealf(diff * conjf(diff));
+
+        if (dist < min_dist)
+        {
+            min_dist = dist;
+            best_index = candidates[c];
+        }
+    }
+
+    return best_index;
+}
+
+bool gam_demodulate_hard(const GAMConstellation *constellation, const float complex symbols[], int num_symbols,
+                         int bits[])
+{
+    if (!constellation || !constellation->initialized || !symbols || !bits || num_symbols < 0)
+    {
+        printf("Error: Constelacion no inicializada para demodulacion\n");
+        return true;
+    }
+
+    const int bits_per_symbol = constellation->bits_per_symbol;
+
+    for (int i = 0; i < num_symbols; i++)
+    {
+        int index = gam_decide_hard(constellation, symbols[i]);
+        if (index == -1) return true;
+
+        for (int j = 0; j < bits_per_symbol; j++)
+        {
+            bits[i * bits_per_symbol + j] = constellation->points[index].bits[j];
+        }
+    }
+
+    return false;
+}
+
+
+// FUNCIONES DEMAPEADOR SUAVE
+// LLR(b) = log P(b = 0 | y) / P(b = 1 | y): positivo favorece el bit 0
+// Max-log: (min_{b=1} |y - s|^2 - min_{b=0} |y - s|^2) / sigma^2. Exacto: log-sum-exp sobre cada mitad.
+static float saturate_llr(float llr)
+{
+    return (llr > LLR_SATURATION) ? LLR_SATURATION : (llr < -LLR_SATURATION) ? -LLR_SATURATION : llr;
+}
+
+static void gam_llr_block(const GAMConstellation *constellation, const float complex symbols[], int count,
+                          float inverse_variance, bool exact, float llrs[])
+{
+    const int bits_per_symbol = constellation->bits_per_symbol;
+    float y_re[LLR_BLOCK], y_im[LLR_BLOCK], distance[LLR_BLOCK];
+    float min_zero[MAX_BPS][LLR_BLOCK], min_one[MAX_BPS][LLR_BLOCK];
+
+    // Bloque siempre completo (cola a cero): bucles de longitud fija, vectorizables sin epílogo
+    for (int s = 0; s < LLR_BLOCK; s++)
+    {
+        y_re[s] = (s < count) ? crealf(symbols[s]) : 0.0f;
+        y_im[s] = (s < count) ? cimagf(symbols[s]) : 0.0f;
+    }
+    for (int k = 0; k < bits_per_symbol; k++)
+    {
+        for (int s = 0; s < LLR_BLOCK; s++) {   min_zero[k][s] = FLT_MAX; min_one[k][s] = FLT_MAX;   }
+    }
+
+    // Bucle externo sobre puntos, interno sobre símbolos: distancias y mínimos elemento a elemento (SIMD)
+    for (int j = 0; j < constellation->num_points; j++)
+    {
+        const float p_re = constellation->point_re[j], p_im = constellation->point_im[j];
+
+        for (int s = 0; s < LLR_BLOCK; s++)
+        {
+            float dx = y_re[s] - p_re, dy = y_im[s] - p_im;
+            distance[s] = dx * dx + dy * dy;
+        }
+
+        for (int k = 0; k < bits_per_symbol; k++)
+        {
+            float *target = constellation->points[j].bits[k] ? min_one[k] : min_zero[k];
+            for (int s = 0; s < LLR_BLOCK; s++) {   target[s] = (distance[s] < target[s]) ? distance[s] : target[s];   }
+        }
+    }
+
+    for (int s = 0; s < count; s++)
+    {
+        for (int k = 0; k < bits_per_symbol; k++)
+        {
+            llrs[s * bits_per_symbol + k] = saturate_llr((min_one[k][s] - min_zero[k][s]) * inverse_variance);
+        }
+    }
+
+    if (!exact) return;
+
+    // Log-sum-exp referido a la distancia mínima global (la mitad ganadora suma >= 1, sin desbordamiento)
+    float sum_zero[MAX_BPS][LLR_BLOCK], sum_one[MAX_BPS][LLR_BLOCK], reference[LLR_BLOCK];
+    for (int s = 0; s < LLR_BLOCK; s++)
+    {
+        reference[s] = (min_zero[0][s] < min_one[0][s]) ? min_zero[0][s] : min_one[0][s];
+    }
+    for (int k = 0; k < bits_per_symbol; k++)
+    {
+        for (int s = 0; s < LLR_BLOCK; s++) {   sum_zero[k][s] = 0.0f; sum_one[k][s] = 0.0f;   }
+    }
+
+    for (int j = 0; j < constellation->num_points; j++)
+    {
+        const float p_re = constellation->point_re[j], p_im = constellation->point_im[j];
+
+        for (int s = 0; s < LLR_BLOCK; s++)
+        {
+            float dx = y_re[s] - p_re, dy = y_im[s] - p_im;
+            distance[s] = expf(-(dx * dx + dy * dy - reference[s]) * inverse_variance);
+        }
+
+        for (int k = 0; k < bits_per_symbol; k++)
+        {
+            float *target = constellation->points[j].bits[k] ? sum_one[k] : sum_zero[k];
+            for (int s = 0; s < LLR_BLOCK; s++) {   target[s] += distance[s];   }
+        }
+    }
+
+    // Mitad perdedora sin masa representable: se conserva el valor max-log
+    for (int s = 0; s < count; s++)
+    {
+        for (int k = 0; k < bits_per_symbol; k++)
+        {
+            if (sum_zero[k][s] > 0.0f && sum_one[k][s] > 0.0f)
+            {
+                llrs[s * bits_per_symbol + k] = saturate_llr(logf(sum_zero[k][s]) - logf(sum_one[k][s]));
+            }
+        }
+    }
+}
+
+// Órdenes altos: solo cuentan los puntos a menos de LLR_SATURATION * sigma^2 (en distancia^2) del más cercano;
+// un bit sin puntos de una de sus mitades en esa región queda saturado igual que en la búsqueda completa.
+// El modo exacto duplica el margen para que la masa descartada no altere los LLR no saturados.
+static void spatial_llr(const GAMConstellation *constellation, float complex symbol, float inverse_variance, bool exact,
+                        float llrs[])
+{
+    const int bits_per_symbol = constellation->bits_per_symbol;
+    SpatialQuery query;
+    if (init_spatial_query(constellation, &query, symbol, false))
+    {
+        for (int k = 0; k < bits_per_symbol; k++) {   llrs[k] = 0.0f;   }
+        return;
+    }
+
+    query.margin = (exact ? 2.0f : 1.0f) * LLR_SATURATION / inverse_variance;
+    query.inverse_variance = inverse_variance;
+    query.exact = exact;
+    for (int k = 0; k < bits_per_symbol; k++)
+    {
+        query.minimum[0][k] = FLT_MAX;
+        query.minimum[1][k] = FLT_MAX;
+        query.sum[0][k] = 0.0f;
+        query.sum[1][k] = 0.0f;
+    }
+    spatial_search(constellation, &query);
+
+    for (int k = 0; k < bits_per_symbol; k++)
+    {
+        float llr = (query.minimum[1][k] - query.minimum[0][k]) * inverse_variance;
+        if (exact && query.sum[0][k] > 0.0f && query.sum[1][k] > 0.0f)
+        {
+            llr = logf(query.sum[0][k]) - logf(query.sum[1][k]);
+        }
+        llrs[k] = saturate_llr(llr);
+    }
+}
+
+bool gam_demodulate_llr(const GAMConstellation *constellation, const float complex symbols[], int num_symbols,
+                        float noise_variance, bool exact, float llrs[])
+{
+    if (!constellation || !constellation->initialized || !symbols || !llrs || num_symbols < 0)
+    {
+        printf("Error: Constelacion no inicializada para demapeo suave\n");
+        return true;
+    }
+
+    // La distancia mínima al cuadrado escala con 1/N: el suelo también, para no saturar órdenes altos
+    float minimum_variance = LLR_MIN_NOISE_VARIANCE_POINTS / (float)constellation->num_points;
+    if (!(noise_variance > minimum_variance)) noise_variance = minimum_variance;
+    float inverse_variance = 1.0f / noise_variance;
+
+    if (constellation->use_spatial_index)
+    {
+        for (int i = 0; i < num_symbols; i++)
+        {
+            spatial_llr(constellation, symbols[i], inverse_variance, exact, &llrs[i * constellation->bits_per_symbol]);
+        }
+        return false;
+    }
+
+    for (int start = 0; start < num_symbols; start += LLR_BLOCK)
+    {
+        int count = (num_symbols - start < LLR_BLOCK) ? num_symbols - start : LLR_BLOCK;
+        gam_llr_block(constellation, &symbols[start], count, inverse_variance, exact,
+                      &llrs[start * constellation->bits_per_symbol]);
+    }
+
+    return false;
+}
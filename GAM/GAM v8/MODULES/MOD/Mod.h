@@ -4,17 +4,51 @@
 #include "../../MODULES/Common.h"
 
 
-// CONSTELACIÓN
-bool init_golden_modulation(Constellation constellation[C_POINTS]);
+// CONSTELACIÓN (orden en tiempo de ejecución, MIN_BPS a MAX_BPS bits por símbolo, etiquetado generado)
+bool init_golden_modulation(Constellation constellation[], int bits_per_symbol);
 
-int calculate_min_distance_hard(float complex symbol, Constellation constellation[C_POINTS]);
+int calculate_min_distance_hard(float complex symbol, const Constellation constellation[], int num_points);
+
+// Constelación construida una vez con tabla inversa etiqueta -> punto
+bool init_gam_constellation(GAMConstellation *constellation, int bits_per_symbol);
+
+// Caché por orden, construida en la primera petición de cada orden (segura entre hilos); NULL si el orden
+// no es válido. free_gam_constellations solo cuando ningún hilo la usa
+const GAMConstellation *get_gam_constellation(int bits_per_symbol);
+
+const GAMConstellation *default_gam_constellation(void);
+
+void free_gam_constellations(void);
+
+// Decisión dura por rejilla 2D; índice espacial polar en órdenes altos (= calculate_min_distance_hard)
+int gam_decide_hard(const GAMConstellation *constellation, float complex symbol);
 
 
 // MODULACIÓN Y DEMODULACIÓN
-bool golden_modulation_hard(const int interleaved_bits[TOTAL_BITS_REPEATED], float complex symbols[TOTAL_SYMBOLS]);
+bool golden_modulation_hard(const int interleaved_bits[TOTAL_BITS_REPEATED], float complex symbols[MAX_BLOCK_SYMBOLS]);
+
+// Un acceso a tabla por símbolo; num_symbols arbitrario (bits sueltos o empaquetados MSB primero)
+bool gam_modulate(const GAMConstellation *constellation, const int bits[], int num_symbols,
+                  float complex symbols[]);
+
+bool gam_modulate_packed(const GAMConstellation *constellation, const uint8_t packed_bits[], int num_symbols,
+                         float complex symbols[]);
+
+// Bloque de transporte: constellation->symbols_per_block símbolos (bits de relleno a cero al final)
+bool gam_modulate_block(const GAMConstellation *constellation, const int interleaved_bits[TOTAL_BITS_REPEATED],
+                        float complex symbols[MAX_BLOCK_SYMBOLS]);
+
+bool golden_demodulation_hard(const float complex symbols[MAX_BLOCK_SYMBOLS], const GAMConstellation *constellation,
+                              int interleaved_bits[MAX_BLOCK_BITS]);
+
+bool gam_demodulate_hard(const GAMConstellation *constellation, const float complex symbols[], int num_symbols,
+                         int bits[]);
+
 
-bool golden_demodulation_hard(float complex symbols[TOTAL_SYMBOLS], Constellation constellation[C_POINTS],
-                              int interleaved_bits[TOTAL_BITS_REPEATED]);
+// DEMAPEO SUAVE (LLR por bit, max-log o log-sum-exp exacto, saturados a +-LLR_SATURATION;
+// noise_variance = E|n|^2 complejo)
+bool gam_demodulate_llr(const GAMConstellation *constellation, const float complex symbols[], int num_symbols,
+                        float noise_variance, bool exact, float llrs[]);
 
 
 #endif //GAM_MOD_H
@@ -1,4 +1,114 @@
 #include "PRB.h"
+#include "../FFT/FFT.h"
+#include "../FRAME/Frame.h"
+
+#if (N_FFT & (N_FFT - 1)) != 0
+    #error "N_FFT debe ser potencia de 2"
+#endif
+
+// Plan FFT compartido por TX y RX (twiddles calculados una sola vez)
+static FFTPlan prb_fft_plan;
+
+static const FFTPlan *get_prb_fft_plan(void)
+{
+    if (!prb_fft_plan.initialized && init_fft_plan(&prb_fft_plan, N_FFT)) return NULL;
+
+    return &prb_fft_plan;
+}
+
+// Plan podado para la banda del PRB (NULL si la ocupación no es dispersa)
+static PrunedFFTPlan prb_pruned_plan;
+
+static const PrunedFFTPlan *get_prb_pruned_plan(void)
+{
+    if (!pruned_fft_is_beneficial(N_FFT, PRB_SUBCARRIERS)) return NULL;
+    if (!prb_pruned_plan.initialized &&
+        init_pruned_fft_plan(&prb_pruned_plan, N_FFT, SUBCARRIERS_START, PRB_SUBCARRIERS)) return NULL;
+
+    return &prb_pruned_plan;
+}
+
+// Memoria de trabajo de los lotes OFDM: crece bajo demanda y se reutiliza entre llamadas.
+// Una por hilo, porque los receptores de una captura procesan lotes en paralelo.
+static __thread float *prb_batch_scratch = NULL;
+static __thread int prb_batch_scratch_lanes = 0;
+
+static float *get_prb_batch_scratch(int lanes)
+{
+    if (lanes > prb_batch_scratch_lanes)
+    {
+        float *buffer = realloc(prb_batch_scratch, (size_t)2 * (N_FFT + PRB_SUBCARRIERS) * lanes * sizeof(float));
+        if (!buffer)
+        {
+            printf("Error: Sin memoria para OFDM en lote (%d simbolos)\n", lanes);
+            return NULL;
+        }
+
+        prb_batch_scratch = buffer;
+        prb_batch_scratch_lanes = lanes;
+    }
+
+    return prb_batch_scratch;
+}
+
+void free_prb_batch_scratch(void)
+{
+    free(prb_batch_scratch);
+    prb_batch_scratch = NULL;
+    prb_batch_scratch_lanes = 0;
+}
+
+bool init_prb_ofdm_plans(void)
+{
+    if (!get_prb_fft_plan()) return true;
+    if (pruned_fft_is_beneficial(N_FFT, PRB_SUBCARRIERS) && !get_prb_pruned_plan()) return true;
+
+    // Fija también los núcleos FFT antes de que los consulten varios hilos
+    fft_kernels_name();
+
+    return false;
+}
+
+// Subportadoras del símbolo sym (datos + pilotos) en orden de banda
+static void prb_symbol_to_band(const PRB_Grid *grid, int sym, float scale, float complex band[PRB_SUBCARRIERS])
+{
+    for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
+    {
+        // Verificar si es posición de piloto
+        bool is_pilot = false;
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
+        {
+            if (sc == grid->pilot_positions[p])
+            {
+                band[sc] = grid->pilot_symbols[sym][p] * scale;
+                is_pilot = true;
+                break;
+            }
+        }
+        // Si no es piloto, usar dato
+        if (!is_pilot) { band[sc] = grid->data_symbols[sym][sc] * scale; }
+    }
+}
+
+static void band_to_prb_symbol(const float complex band[PRB_SUBCARRIERS], float scale, int sym, PRB_Grid *grid)
+{
+    for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
+    {
+        // Verificar si es posición de piloto
+        bool is_pilot = false;
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
+        {
+            if (sc == grid->pilot_positions[p])
+            {
+                grid->pilot_symbols[sym][p] = band[sc] * scale;
+                is_pilot = true;
+                break;
+            }
+        }
+        // Si no es piloto, extraer dato
+        if (!is_pilot) { grid->data_symbols[sym][sc] = band[sc] * scale; }
+    }
+}
 
 bool init_prb_grid(PRB_Grid *grid)
 {
@@ -35,7 +145,7 @@ bool init_prb_grid(PRB_Grid *grid)
     return false;
 }
 
-bool map_data_to_prb(const float complex data_symbols[TOTAL_SYMBOLS], PRB_Grid *grid)
+bool map_data_to_prb(const float complex data_symbols[], int num_symbols, PRB_Grid *grid)
 {
     if (!grid || !grid->initialized)
     {
@@ -43,19 +153,19 @@ bool map_data_to_prb(const float complex data_symbols[TOTAL_SYMBOLS], PRB_Grid *
         return true;
     }
 
-    if (TOTAL_SYMBOLS > DATA_RE_PER_PRB)
+    if (num_symbols > DATA_RE_PER_PRB)
     {
         printf("Error: Demasiados símbolos (%d) para REs disponibles (%d)\n",
-               TOTAL_SYMBOLS, DATA_RE_PER_PRB);
+               num_symbols, DATA_RE_PER_PRB);
         return true;
     }
 
     int data_idx = 0;
 
     // Distribuir símbolos en el grid evitando posiciones de pilotos
-    for (int sym = 0; sym < PRB_SYMBOLS && data_idx < TOTAL_SYMBOLS; sym++)
+    for (int sym = 0; sym < PRB_SYMBOLS && data_idx < num_symbols; sym++)
     {
-        for (int sc = 0; sc < PRB_SUBCARRIERS && data_idx < TOTAL_SYMBOLS; sc++)
+        for (int sc = 0; sc < PRB_SUBCARRIERS && data_idx < num_symbols; sc++)
         {
             // Verificar si esta posición es piloto
             bool is_pilot = false;
@@ -74,14 +184,14 @@ bool map_data_to_prb(const float complex data_symbols[TOTAL_SYMBOLS], PRB_Grid *
     }
 
     printf("Datos mapeados al PRB: %d/%d simbolos en grid %dx%d\n",
-           data_idx, TOTAL_SYMBOLS, PRB_SYMBOLS, PRB_SUBCARRIERS);
+           data_idx, num_symbols, PRB_SYMBOLS, PRB_SUBCARRIERS);
 
     return false;
 }
 
-bool extract_data_from_prb(const PRB_Grid *grid, float complex data_symbols[TOTAL_SYMBOLS])
+bool extract_data_from_prb(const PRB_Grid *grid, int num_symbols, float complex data_symbols[])
 {
-    if (!grid || !grid->initialized)
+    if (!grid || !grid->initialized || num_symbols > DATA_RE_PER_PRB)
     {
         printf("Error: Grid PRB no inicializado\n");
         return true;
@@ -90,9 +200,9 @@ bool extract_data_from_prb(const PRB_Grid *grid, float complex data_symbols[TOTA
     int data_idx = 0;
 
     // Extraer datos del grid evitando posiciones de pilotos
-    for (int sym = 0; sym < PRB_SYMBOLS && data_idx < TOTAL_SYMBOLS; sym++)
+    for (int sym = 0; sym < PRB_SYMBOLS && data_idx < num_symbols; sym++)
     {
-        for (int sc = 0; sc < PRB_SUBCARRIERS && data_idx < TOTAL_SYMBOLS; sc++)
+        for (int sc = 0; sc < PRB_SUBCARRIERS && data_idx < num_symbols; sc++)
         {
             // Verificar si esta posición es piloto
             bool is_pilot = false;
@@ -106,114 +216,248 @@ bool extract_data_from_prb(const PRB_Grid *grid, float complex data_symbols[TOTA
         }
     }
 
-    printf("Datos extraidos del PRB: %d/%d simbolos\n", data_idx, TOTAL_SYMBOLS);
+    printf("Datos extraidos del PRB: %d/%d simbolos\n", data_idx, num_symbols);
 
     return false;
 }
 
 bool generate_prb_ofdm_symbols(const PRB_Grid *grid, float complex ofdm_symbols[PRB_SYMBOLS][N_FFT])
 {
-    if (!grid || !grid->initialized)
+    return generate_prb_ofdm_symbols_batch(grid, 1, (float complex (*)[PRB_SYMBOLS][N_FFT])ofdm_symbols);
+}
+
+bool process_received_prb_ofdm(const float complex received_symbols[PRB_SYMBOLS][N_FFT], PRB_Grid *grid)
+{
+    return process_received_prb_ofdm_batch((const float complex (*)[PRB_SYMBOLS][N_FFT])received_symbols, grid, 1);
+}
+
+// IFFT en lote; la muestra n del símbolo (prb, sym) se escribe en outputs[prb * PRB_SYMBOLS + sym][n]
+static bool generate_prb_ofdm_core(const PRB_Grid grids[], int num_prbs, float complex *const outputs[])
+{
+    for (int prb = 0; prb < num_prbs; prb++)
     {
-        printf("Error: Grid PRB no inicializado\n");
-        return true;
+        if (!grids[prb].initialized)
+        {
+            printf("Error: Grid PRB %d no inicializado\n", prb);
+            return true;
+        }
     }
 
-    // Para cada símbolo OFDM en el PRB
-    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    const FFTPlan *plan = get_prb_fft_plan();
+    const PrunedFFTPlan *pruned_plan = get_prb_pruned_plan();
+    if (!plan) return true;
+
+    // Un carril por símbolo OFDM: muestra n del carril l en [n * lanes + l]
+    int lanes = num_prbs * PRB_SYMBOLS;
+    float *buffer = get_prb_batch_scratch(lanes);
+    if (!buffer) return true;
+
+    float *time_re = buffer;
+    float *time_im = time_re + N_FFT * lanes;
+    float *band_re = time_im + N_FFT * lanes;
+    float *band_im = band_re + PRB_SUBCARRIERS * lanes;
+
+    // Normalización 1/sqrt(N) aplicada sobre las subportadoras ocupadas
+    float scale = 1.0f / sqrtf(N_FFT);
+
+    // Mapear datos y pilotos de cada símbolo a la banda del PRB (centrada)
+    for (int prb = 0; prb < num_prbs; prb++)
     {
-        // Inicializar subportadoras a cero
-        float complex subcarriers[N_FFT];
-        for (int i = 0; i < N_FFT; i++) { subcarriers[i] = 0.0f + 0.0f * I; }
+        for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+        {
+            int lane = prb * PRB_SYMBOLS + sym;
+            float complex band[PRB_SUBCARRIERS];
+            prb_symbol_to_band(&grids[prb], sym, scale, band);
+
+            for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
+            {
+                band_re[sc * lanes + lane] = crealf(band[sc]);
+                band_im[sc * lanes + lane] = cimagf(band[sc]);
+            }
+        }
+    }
 
-        // Mapear datos y pilotos a subportadoras (centrado)
+    bool error;
+    if (pruned_plan)
+    {
+        // IFFT podada: solo entran los PRB_SUBCARRIERS bins ocupados
+        error = pruned_ifft_batch(pruned_plan, band_re, band_im, lanes, time_re, time_im);
+    }
+    else
+    {
+        for (int i = 0; i < N_FFT * lanes; i++) { time_re[i] = 0.0f; time_im[i] = 0.0f; }
         for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
         {
-            int global_sc_idx = SUBCARRIERS_START + sc;
-            if (global_sc_idx >= 0 && global_sc_idx < N_FFT)
+            for (int lane = 0; lane < lanes; lane++)
             {
-                // Verificar si es posición de piloto
-                bool is_pilot = false;
-                for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
-                {
-                    if (sc == grid->pilot_positions[p])
-                    {
-                        subcarriers[global_sc_idx] = grid->pilot_symbols[sym][p];
-                        is_pilot = true;
-                        break;
-                    }
-                }
-                // Si no es piloto, usar dato
-                if (!is_pilot) { subcarriers[global_sc_idx] = grid->data_symbols[sym][sc]; }
+                time_re[(SUBCARRIERS_START + sc) * lanes + lane] = band_re[sc * lanes + lane];
+                time_im[(SUBCARRIERS_START + sc) * lanes + lane] = band_im[sc * lanes + lane];
             }
         }
+        error = fft_batch_inverse(plan, time_re, time_im, lanes);
+    }
 
-        // Aplicar IDFT para generar símbolo OFDM en tiempo
-        for (int n = 0; n < N_FFT; n++)
+    if (!error)
+    {
+        for (int prb = 0; prb < num_prbs; prb++)
         {
-            ofdm_symbols[sym][n] = 0.0f + 0.0f * I;
-            for (int k = 0; k < N_FFT; k++)
+            for (int sym = 0; sym < PRB_SYMBOLS; sym++)
             {
-                float angle = (float)(2.0f * M_PI * k * n) / N_FFT;
-                ofdm_symbols[sym][n] += subcarriers[k] * (cosf(angle) + sinf(angle) * I);
+                int lane = prb * PRB_SYMBOLS + sym;
+                float complex *out = outputs[lane];
+                for (int n = 0; n < N_FFT; n++)
+                {
+                    out[n] = time_re[n * lanes + lane] + time_im[n * lanes + lane] * I;
+                }
             }
-            ofdm_symbols[sym][n] /= sqrtf(N_FFT);
         }
+
+        printf("Simbolos OFDM generados: %d PRB X %d simbolos X %d muestras\n", num_prbs, PRB_SYMBOLS, N_FFT);
     }
 
-    printf("Simbolos OFDM generados: %d simbolos X %d muestras\n", PRB_SYMBOLS, N_FFT);
+    return error;
+}
 
-    return false;
+bool generate_prb_ofdm_symbols_batch(const PRB_Grid grids[], int num_prbs,
+                                     float complex ofdm_symbols[][PRB_SYMBOLS][N_FFT])
+{
+    if (!grids || num_prbs <= 0)
+    {
+        printf("Error: Lote de PRBs no valido\n");
+        return true;
+    }
+
+    float complex **outputs = malloc((size_t)num_prbs * PRB_SYMBOLS * sizeof(float complex *));
+    if (!outputs)
+    {
+        printf("Error: Sin memoria para OFDM en lote (%d PRBs)\n", num_prbs);
+        return true;
+    }
+
+    for (int prb = 0; prb < num_prbs; prb++)
+    {
+        for (int sym = 0; sym < PRB_SYMBOLS; sym++) { outputs[prb * PRB_SYMBOLS + sym] = ofdm_symbols[prb][sym]; }
+    }
+
+    bool error = generate_prb_ofdm_core(grids, num_prbs, outputs);
+    free(outputs);
+
+    return error;
 }
 
-bool process_received_prb_ofdm(const float complex received_symbols[PRB_SYMBOLS][N_FFT], PRB_Grid *grid)
+bool generate_prb_ofdm_into_frame(const PRB_Grid *grid, FrameBuilder *builder)
 {
-    if (!grid)
+    return generate_prb_ofdm_into_superframe(grid, 1, builder);
+}
+
+bool generate_prb_ofdm_into_superframe(const PRB_Grid grids[], int num_prbs, FrameBuilder *builder)
+{
+    if (!grids || !builder || !builder->initialized || num_prbs <= 0 || num_prbs != builder->num_prbs)
     {
-        printf("Error: Grid PRB no valido\n");
+        printf("Error: Grid PRB o constructor de trama no inicializado\n");
         return true;
     }
 
-    // Procesar cada símbolo OFDM recibido
-    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    int num_symbols = num_prbs * PRB_SYMBOLS;
+    float complex **outputs = malloc((size_t)num_symbols * sizeof(float complex *));
+    if (!outputs)
     {
-        // Aplicar DFT al símbolo recibido
-        float complex subcarriers[N_FFT];
-        for (int k = 0; k < N_FFT; k++)
+        printf("Error: Sin memoria para supertrama (%d simbolos)\n", num_symbols);
+        return true;
+    }
+
+    // Cada IFFT del lote escribe el cuerpo del símbolo en su hueco de la trama final
+    for (int sym = 0; sym < num_symbols; sym++) { outputs[sym] = frame_symbol_slot(builder, sym); }
+
+    bool error = generate_prb_ofdm_core(grids, num_prbs, outputs);
+
+    // El CP se rellena desde el mismo buffer
+    for (int sym = 0; sym < num_symbols && !error; sym++)
+    {
+        error = commit_frame_symbol(builder, sym);
+    }
+
+    free(outputs);
+
+    return error;
+}
+
+bool process_received_prb_ofdm_batch(const float complex received_symbols[][PRB_SYMBOLS][N_FFT],
+                                     PRB_Grid grids[], int num_prbs)
+{
+    if (!grids || num_prbs <= 0)
+    {
+        printf("Error: Lote de PRBs no valido\n");
+        return true;
+    }
+
+    const FFTPlan *plan = get_prb_fft_plan();
+    const PrunedFFTPlan *pruned_plan = get_prb_pruned_plan();
+    if (!plan) return true;
+
+    int lanes = num_prbs * PRB_SYMBOLS;
+    float *buffer = get_prb_batch_scratch(lanes);
+    if (!buffer) return true;
+
+    float *time_re = buffer;
+    float *time_im = time_re + N_FFT * lanes;
+    float *band_re = time_im + N_FFT * lanes;
+    float *band_im = band_re + PRB_SUBCARRIERS * lanes;
+
+    float scale = 1.0f / sqrtf(N_FFT);
+
+    // Reordenar los símbolos recibidos a un carril por símbolo
+    for (int prb = 0; prb < num_prbs; prb++)
+    {
+        for (int sym = 0; sym < PRB_SYMBOLS; sym++)
         {
-            subcarriers[k] = 0.0f + 0.0f * I;
+            int lane = prb * PRB_SYMBOLS + sym;
             for (int n = 0; n < N_FFT; n++)
             {
-                float angle = (float)(-2.0f * M_PI * k * n) / N_FFT;
-                subcarriers[k] += received_symbols[sym][n] * (cosf(angle) + sinf(angle) * I);
+                time_re[n * lanes + lane] = crealf(received_symbols[prb][sym][n]);
+                time_im[n * lanes + lane] = cimagf(received_symbols[prb][sym][n]);
             }
-            subcarriers[k] /= sqrtf(N_FFT);
         }
+    }
 
-        // Extraer datos y pilotos del PRB
-        for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
+    bool error;
+    if (pruned_plan)
+    {
+        // FFT podada: solo se calculan los bins del PRB
+        error = pruned_fft_batch(pruned_plan, time_re, time_im, lanes, band_re, band_im);
+    }
+    else
+    {
+        error = fft_batch_forward(plan, time_re, time_im, lanes);
+        for (int sc = 0; sc < PRB_SUBCARRIERS && !error; sc++)
         {
-            int global_sc_idx = SUBCARRIERS_START + sc;
-            if (global_sc_idx >= 0 && global_sc_idx < N_FFT)
+            for (int lane = 0; lane < lanes; lane++)
             {
-                // Verificar si es posición de piloto
-                bool is_pilot = false;
-                for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
+                band_re[sc * lanes + lane] = time_re[(SUBCARRIERS_START + sc) * lanes + lane];
+                band_im[sc * lanes + lane] = time_im[(SUBCARRIERS_START + sc) * lanes + lane];
+            }
+        }
+    }
+
+    if (!error)
+    {
+        // Extraer datos y pilotos de cada PRB
+        for (int prb = 0; prb < num_prbs; prb++)
+        {
+            for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+            {
+                int lane = prb * PRB_SYMBOLS + sym;
+                float complex band[PRB_SUBCARRIERS];
+                for (int sc = 0; sc < PRB_SUBCARRIERS; sc++)
                 {
-                    if (sc == grid->pilot_positions[p])
-                    {
-                        grid->pilot_symbols[sym][p] = subcarriers[global_sc_idx];
-                        is_pilot = true;
-                        break;
-                    }
+                    band[sc] = band_re[sc * lanes + lane] + band_im[sc * lanes + lane] * I;
                 }
-                // Si no es piloto, extraer dato
-                if (!is_pilot) { grid->data_symbols[sym][sc] = subcarriers[global_sc_idx]; }
+                band_to_prb_symbol(band, scale, sym, &grids[prb]);
             }
         }
-    }
 
-    printf("PRB OFDM procesado: %d simbolos extraidos\n", PRB_SYMBOLS);
+        printf("PRB OFDM procesado: %d PRB X %d simbolos extraidos\n", num_prbs, PRB_SYMBOLS);
+    }
 
-    return false;
+    return error;
 }
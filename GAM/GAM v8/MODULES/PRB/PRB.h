@@ -6,13 +6,32 @@
 
 bool init_prb_grid(PRB_Grid *grid);
 
-bool map_data_to_prb(const float complex data_symbols[TOTAL_SYMBOLS], PRB_Grid *grid);
+bool map_data_to_prb(const float complex data_symbols[], int num_symbols, PRB_Grid *grid);
 
-bool extract_data_from_prb(const PRB_Grid *grid, float complex data_symbols[TOTAL_SYMBOLS]);
+bool extract_data_from_prb(const PRB_Grid *grid, int num_symbols, float complex data_symbols[]);
 
 bool generate_prb_ofdm_symbols(const PRB_Grid *grid, float complex ofdm_symbols[PRB_SYMBOLS][N_FFT]);
 
 bool process_received_prb_ofdm(const float complex received_symbols[PRB_SYMBOLS][N_FFT], PRB_Grid *grid);
 
 
+// OFDM EN LOTE (todos los símbolos de num_prbs PRBs en una sola transformada)
+bool generate_prb_ofdm_symbols_batch(const PRB_Grid grids[], int num_prbs,
+                                     float complex ofdm_symbols[][PRB_SYMBOLS][N_FFT]);
+
+bool generate_prb_ofdm_into_frame(const PRB_Grid *grid, FrameBuilder *builder);
+
+bool generate_prb_ofdm_into_superframe(const PRB_Grid grids[], int num_prbs, FrameBuilder *builder);
+
+bool process_received_prb_ofdm_batch(const float complex received_symbols[][PRB_SYMBOLS][N_FFT],
+                                     PRB_Grid grids[], int num_prbs);
+
+
+// PLANES COMPARTIDOS (crearlos antes de usar la cadena OFDM desde varios hilos)
+bool init_prb_ofdm_plans(void);
+
+// Libera la memoria de trabajo de los lotes OFDM del hilo que llama (antes de que termine el hilo)
+void free_prb_batch_scratch(void);
+
+
 #endif //GAM_PRB_H
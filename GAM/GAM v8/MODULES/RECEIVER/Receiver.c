@@ -0,0 +1,445 @@
+#include "Receiver.h"
+#include "../SYNC/Sync.h"
+#include "../PRB/PRB.h"
+#include "../FRAME/Frame.h"
+#include "../TBLOCK/TBlock.h"
+#include "../MOD/Mod.h"
+#include "../DETECTION/Detection.h"
+
+#define SUPERFRAME_PAYLOAD_SAMPLES (SUPERFRAME_PRBS * PRB_PAYLOAD_SAMPLES)
+#define GATE_LOOKBACK (ENERGY_WINDOW + ENERGY_GUARD_SAMPLES)
+
+// FUNCIONES CADENA RX
+bool init_receiver_state(ReceiverState *state)
+{
+    if (!state)
+    {
+        printf("Error: Estado del receptor no valido\n");
+        return true;
+    }
+
+    if (init_cfo_residual_tracker(&state->cfo_tracker, CFO_ALPHA)) return true;
+    if (init_cpe_tracker(&state->cpe_tracker, CPE_ALPHA)) return true;
+    if (init_sco_tracker(&state->sco_tracker, SCO_ALPHA)) return true;
+
+    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    {
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++) { state->previous_pilots[sym][p] = 0.0f + 0.0f * I; }
+    }
+    state->first_frame = true;
+
+    return false;
+}
+
+// Sincronización con pilotos + demodulación + decodificación de un PRB ya en frecuencia
+static bool decode_prb_grid(ReceiverState *state, PRB_Grid *rx_prb, const GAMConstellation *constellation,
+                            TransportBlock *rx_tb)
+{
+    // SINCRONIZACIÓN AVANZADA
+    printf("\n--- SINCRONIZACION ---\n");
+
+    // CFO Residual
+    if (estimate_cfo_residual(rx_prb->pilot_symbols, &state->cfo_tracker))
+    {
+        printf("Error en estimación CFO residual\n");
+    }
+    else if (state->cfo_tracker.pilots_used >= TOTAL_PILOTS / 3)
+    {
+        apply_cfo_residual_correction(rx_prb, &state->cfo_tracker);
+    }
+
+    // CPE
+    if (estimate_cpe(rx_prb->pilot_symbols, &state->cpe_tracker))
+    {
+        printf("Error en estimación CPE\n");
+    }
+    else if (state->cpe_tracker.pilots_used >= PRB_SYMBOLS)
+    {
+        apply_cpe_correction(rx_prb, &state->cpe_tracker);
+    }
+
+    // SCO (solo después del primer frame)
+    if (!state->first_frame)
+    {
+        if (estimate_sco(rx_prb->pilot_symbols, state->previous_pilots, &state->sco_tracker))
+        {
+            printf("Error en estimación SCO\n");
+        }
+        else if (state->sco_tracker.pilots_used >= TOTAL_PILOTS / 2)
+        {
+            apply_sco_compensation(rx_prb, &state->sco_tracker);
+        }
+    }
+    else
+    {
+        printf("Primer frame - inicializando SCO tracker\n");
+        state->first_frame = false;
+    }
+
+    // Guardar pilotos para siguiente frame
+    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    {
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
+        {
+            state->previous_pilots[sym][p] = rx_prb->pilot_symbols[sym][p];
+        }
+    }
+
+
+    // EXTRAER DATOS DEL PRB RECIBIDO
+    float complex rx_symbols[MAX_BLOCK_SYMBOLS];
+    extract_data_from_prb(rx_prb, constellation->symbols_per_block, rx_symbols);
+
+
+    // DEMODULAR Y DECODIFICAR (el resultado del CRC queda en rx_tb->crc_valid)
+#if SOFT_DECODING
+    float noise_variance;
+    estimate_pilot_noise_variance(rx_prb->pilot_symbols, &noise_variance);
+
+    float rx_llrs[MAX_BLOCK_BITS];
+    if (gam_demodulate_llr(constellation, rx_symbols, constellation->symbols_per_block, noise_variance, false,
+                           rx_llrs)) return true;
+
+    process_received_block_soft(rx_llrs, rx_tb);
+#else
+    int rx_interleaved_bits[MAX_BLOCK_BITS];
+    if (gam_demodulate_hard(constellation, rx_symbols, constellation->symbols_per_block,
+                            rx_interleaved_bits)) return true;
+
+    process_received_block(rx_interleaved_bits, rx_tb);
+#endif
+
+    return false;
+}
+
+bool receive_prb_frame(ReceiverState *state, const float complex received_frame[], int frame_start_index,
+                       int total_frame_samples, const GAMConstellation *constellation, TransportBlock *rx_tb)
+{
+    return receive_prb_superframe(state, received_frame, frame_start_index, total_frame_samples, 1,
+                                  constellation, rx_tb);
+}
+
+bool receive_prb_superframe(ReceiverState *state, const float complex received_frame[], int frame_start_index,
+                            int total_frame_samples, int num_prbs, const GAMConstellation *constellation,
+                            TransportBlock rx_tbs[])
+{
+    if (!state || !rx_tbs || num_prbs <= 0)
+    {
+        printf("Error: Receptor no inicializado\n");
+        return true;
+    }
+
+    int payload_end = frame_start_index + num_prbs * PRB_PAYLOAD_SAMPLES;
+    if (frame_start_index < 0 || payload_end > total_frame_samples)
+    {
+        printf("Error: Supertrama demasiado corta para %d PRBs (fin %d, disponible %d)\n",
+               num_prbs, payload_end, total_frame_samples);
+        return true;
+    }
+
+    float complex (*rx_ofdm_symbols)[PRB_SYMBOLS][N_FFT] = malloc((size_t)num_prbs * sizeof(*rx_ofdm_symbols));
+    PRB_Grid *rx_prbs = malloc((size_t)num_prbs * sizeof(PRB_Grid));
+    if (!rx_ofdm_symbols || !rx_prbs)
+    {
+        printf("Error: Sin memoria para supertrama de %d PRBs\n", num_prbs);
+        free(rx_ofdm_symbols);
+        free(rx_prbs);
+        return true;
+    }
+
+    // Timing único: los PRBs van seguidos tras el preámbulo, se quita el CP al copiar
+    for (int prb = 0; prb < num_prbs; prb++)
+    {
+        init_prb_grid(&rx_prbs[prb]);
+        for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+        {
+            const float complex *body = &received_frame[frame_start_index + prb * PRB_PAYLOAD_SAMPLES +
+                                                        sym * (N_FFT + CP_LEN) + CP_LEN];
+            for (int i = 0; i < N_FFT; i++) { rx_ofdm_symbols[prb][sym][i] = body[i]; }
+        }
+    }
+
+    // Todas las FFT de la supertrama en un solo lote
+    bool error = process_received_prb_ofdm_batch(rx_ofdm_symbols, rx_prbs, num_prbs);
+
+    // Los trackers (CFO, CPE, SCO) se arrastran de un PRB al siguiente
+    for (int prb = 0; prb < num_prbs && !error; prb++)
+    {
+        error = decode_prb_grid(state, &rx_prbs[prb], constellation, &rx_tbs[prb]);
+    }
+
+    free(rx_ofdm_symbols);
+    free(rx_prbs);
+
+    return error;
+}
+
+
+// FUNCIONES RECEPTOR STREAMING
+bool init_stream_receiver(StreamReceiver *receiver, TransportBlockCallback on_block, void *user_data)
+{
+    if (!receiver || !on_block)
+    {
+        printf("Error: Parametros invalidos para receptor streaming\n");
+        return true;
+    }
+
+    // Capacidad para al menos dos supertramas completas
+    receiver->capacity = 1;
+    while (receiver->capacity < 2 * SUPERFRAME_SAMPLES) { receiver->capacity <<= 1; }
+
+    receiver->ring = malloc((size_t)2 * receiver->capacity * sizeof(float complex));
+    if (!receiver->ring)
+    {
+        printf("Error: Sin memoria para buffer circular (%d muestras)\n", receiver->capacity);
+        return true;
+    }
+
+    if (init_preamble_correlator(&receiver->correlator) ||
+        init_receiver_state(&receiver->rx_state) ||
+        !(receiver->constellation = default_gam_constellation()) ||
+        init_energy_detector(&receiver->gate, ENERGY_ON_DB, ENERGY_OFF_DB, ENERGY_GUARD_SAMPLES))
+    {
+        free(receiver->ring);
+        receiver->ring = NULL;
+        return true;
+    }
+
+    receiver->write_count = 0;
+    receiver->search_position = 0;
+    receiver->candidate_index = -1;
+    receiver->candidate_metric = 0.0f;
+    receiver->pending_frame_start = -1;
+    receiver->on_block = on_block;
+    receiver->user_data = user_data;
+    receiver->frames_decoded = 0;
+    receiver->frames_crc_valid = 0;
+    receiver->gating_enabled = true;
+    receiver->gate_start = 0;
+    receiver->gate_end = 0;
+    receiver->samples_skipped = 0;
+    receiver->initialized = true;
+
+    return false;
+}
+
+bool configure_stream_energy_gate(StreamReceiver *receiver, bool enabled, float on_db, float off_db,
+                                  int guard_samples)
+{
+    if (!receiver || !receiver->initialized)
+    {
+        printf("Error: Receptor streaming no inicializado\n");
+        return true;
+    }
+    if (guard_samples > ENERGY_GUARD_SAMPLES)
+    {
+        printf("Error: Margen de guarda %d mayor que el retenido en el buffer (%d)\n",
+               guard_samples, ENERGY_GUARD_SAMPLES);
+        return true;
+    }
+
+    // El detector sigue contando muestras desde la posición actual del flujo
+    long long sample_index = receiver->write_count;
+    if (init_energy_detector(&receiver->gate, on_db, off_db, guard_samples)) return true;
+    receiver->gate.sample_index = sample_index;
+    receiver->gate.segment_start = sample_index;
+    receiver->gate_start = sample_index;
+    receiver->gating_enabled = enabled;
+
+    return false;
+}
+
+// Cambia el orden de modulación de las supertramas siguientes (constelación de la caché, sin reconstruir)
+bool configure_stream_modulation(StreamReceiver *receiver, int bits_per_symbol)
+{
+    if (!receiver || !receiver->initialized)
+    {
+        printf("Error: Receptor streaming no inicializado\n");
+        return true;
+    }
+
+    const GAMConstellation *constellation = get_gam_constellation(bits_per_symbol);
+    if (!constellation) return true;
+
+    receiver->constellation = constellation;
+
+    return false;
+}
+
+void free_stream_receiver(StreamReceiver *receiver)
+{
+    if (!receiver) return;
+
+    free(receiver->ring);
+    receiver->ring = NULL;
+    receiver->initialized = false;
+}
+
+// Vista contigua de las muestras desde el índice absoluto start
+static const float complex *ring_view(const StreamReceiver *receiver, long long start)
+{
+    return &receiver->ring[start & (receiver->capacity - 1)];
+}
+
+// Primera muestra absoluta que todavía hay que conservar en el buffer
+static long long retained_from(const StreamReceiver *receiver)
+{
+    long long oldest = receiver->search_position;
+
+    if (receiver->candidate_index >= 0 && receiver->candidate_index < oldest) oldest = receiver->candidate_index;
+    if (receiver->pending_frame_start >= 0 && receiver->pending_frame_start < oldest) oldest = receiver->pending_frame_start;
+
+    return oldest;
+}
+
+static void stream_receiver_process(StreamReceiver *receiver)
+{
+    while (true)
+    {
+        // Supertrama detectada: decodificar en cuanto esté completa
+        if (receiver->pending_frame_start >= 0)
+        {
+            long long frame_start = receiver->pending_frame_start;
+            if (frame_start + SUPERFRAME_PAYLOAD_SAMPLES > receiver->write_count) return;
+
+            TransportBlock rx_tbs[SUPERFRAME_PRBS];
+            if (!receive_prb_superframe(&receiver->rx_state, ring_view(receiver, frame_start), 0,
+                                        SUPERFRAME_PAYLOAD_SAMPLES, SUPERFRAME_PRBS, receiver->constellation, rx_tbs))
+            {
+                for (int prb = 0; prb < SUPERFRAME_PRBS; prb++)
+                {
+                    receiver->frames_decoded++;
+                    if (rx_tbs[prb].crc_valid) receiver->frames_crc_valid++;
+                    receiver->on_block(&rx_tbs[prb], frame_start, prb, receiver->user_data);
+                }
+            }
+
+            // La trama ya procesada no se vuelve a correlar
+            receiver->search_position = frame_start + SUPERFRAME_PAYLOAD_SAMPLES;
+            receiver->pending_frame_start = -1;
+            receiver->candidate_index = -1;
+            receiver->candidate_metric = 0.0f;
+            continue;
+        }
+
+        // Compuerta de energía: en reposo no se correla, solo se conserva el margen previo
+        long long search_end = receiver->write_count;
+        if (receiver->gating_enabled && receiver->candidate_index < 0)
+        {
+            if (receiver->search_position < receiver->gate_start)
+            {
+                receiver->samples_skipped += receiver->gate_start - receiver->search_position;
+                receiver->search_position = receiver->gate_start;
+            }
+
+            if (!receiver->gate.active)
+            {
+                if (receiver->search_position + PREAMBLE_LEN > receiver->gate_end)
+                {
+                    long long skip_to = receiver->write_count - GATE_LOOKBACK;
+                    if (skip_to > receiver->search_position)
+                    {
+                        receiver->samples_skipped += skip_to - receiver->search_position;
+                        receiver->search_position = skip_to;
+                    }
+                    return;
+                }
+                search_end = receiver->gate_end;
+            }
+        }
+
+        // Buscar preámbulo desde el último desplazamiento no correlado
+        long long available = search_end - receiver->search_position;
+        if (available < PREAMBLE_LEN) return;
+
+        const float complex *view = ring_view(receiver, receiver->search_position);
+        int view_length = (int)available;
+        int offsets = view_length - PREAMBLE_LEN + 1;
+        bool frame_found = false;
+
+        reset_preamble_correlator(&receiver->correlator, view, 0);
+
+        for (int d = 0; d < offsets; d++)
+        {
+            long long offset = receiver->search_position + d;
+
+            // Pico confirmado cuando no aparece otro mayor en PREAMBLE_LEN muestras
+            if (receiver->candidate_index >= 0 && offset - receiver->candidate_index >= PREAMBLE_LEN)
+            {
+                receiver->pending_frame_start = receiver->candidate_index + PREAMBLE_LEN;
+                receiver->search_position = offset;                // No retener lo ya correlado
+                printf("Stream: preambulo en muestra %lld (correlacion %.4f)\n",
+                       receiver->candidate_index, receiver->candidate_metric);
+                frame_found = true;
+                break;
+            }
+
+            float metric = preamble_correlator_next(&receiver->correlator, view, view_length);
+            if (metric > CORRELATION_THRESHOLD && metric > receiver->candidate_metric)
+            {
+                receiver->candidate_index = offset;
+                receiver->candidate_metric = metric;
+            }
+        }
+
+        if (frame_found) continue;
+
+        receiver->search_position += offsets;
+        return;
+    }
+}
+
+bool stream_receiver_push(StreamReceiver *receiver, const float complex samples[], int num_samples)
+{
+    if (!receiver || !receiver->initialized || (!samples && num_samples > 0))
+    {
+        printf("Error: Receptor streaming no inicializado\n");
+        return true;
+    }
+
+    int mask = receiver->capacity - 1;
+    int consumed = 0;
+
+    while (consumed < num_samples)
+    {
+        // No sobrescribir muestras que aún pueden formar parte de una trama
+        long long in_use = receiver->write_count - retained_from(receiver);
+        int space = receiver->capacity - (int)in_use;
+        if (space <= 0)
+        {
+            printf("Error: Buffer circular lleno (%d muestras retenidas)\n", (int)in_use);
+            return true;
+        }
+
+        int count = num_samples - consumed;
+        if (count > space) count = space;
+
+        for (int i = 0; i < count; i++)
+        {
+            int pos = (int)((receiver->write_count + i) & mask);
+            receiver->ring[pos] = samples[consumed + i];
+            receiver->ring[pos + receiver->capacity] = samples[consumed + i];
+
+            if (!receiver->gating_enabled) continue;
+
+            // Cada segmento se procesa al cerrarse, antes de que se abra el siguiente
+            EnergyGateEvent event = energy_detector_update(&receiver->gate, samples[consumed + i]);
+            if (event == ENERGY_GATE_OPEN)
+            {
+                receiver->gate_start = receiver->gate.segment_start;
+            }
+            else if (event == ENERGY_GATE_CLOSE)
+            {
+                receiver->gate_end = receiver->gate.segment_end;
+                count = i + 1;
+            }
+        }
+
+        receiver->write_count += count;
+        consumed += count;
+
+        stream_receiver_process(receiver);
+    }
+
+    return false;
+}
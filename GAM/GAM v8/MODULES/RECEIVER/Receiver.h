@@ -0,0 +1,32 @@
+#ifndef GAM_RECEIVER_H
+#define GAM_RECEIVER_H
+
+#include "../../MODULES/Common.h"
+
+
+// CADENA RX DE UNA TRAMA (extracción + OFDM + sincronización + demodulación + decodificación)
+bool init_receiver_state(ReceiverState *state);
+
+bool receive_prb_frame(ReceiverState *state, const float complex received_frame[], int frame_start_index,
+                       int total_frame_samples, const GAMConstellation *constellation, TransportBlock *rx_tb);
+
+// Supertrama: num_prbs PRBs seguidos tras un único preámbulo (timing y trackers compartidos)
+bool receive_prb_superframe(ReceiverState *state, const float complex received_frame[], int frame_start_index,
+                            int total_frame_samples, int num_prbs, const GAMConstellation *constellation,
+                            TransportBlock rx_tbs[]);
+
+
+// RECEPTOR EN STREAMING (bloques de tamaño arbitrario, varias tramas por captura, compuerta de energía)
+bool init_stream_receiver(StreamReceiver *receiver, TransportBlockCallback on_block, void *user_data);
+
+void free_stream_receiver(StreamReceiver *receiver);
+
+bool configure_stream_energy_gate(StreamReceiver *receiver, bool enabled, float on_db, float off_db,
+                                  int guard_samples);
+
+bool configure_stream_modulation(StreamReceiver *receiver, int bits_per_symbol);
+
+bool stream_receiver_push(StreamReceiver *receiver, const float complex samples[], int num_samples);
+
+
+#endif //GAM_RECEIVER_H
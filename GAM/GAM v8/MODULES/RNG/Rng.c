@@ -0,0 +1,231 @@
+#include "Rng.h"
+
+#define ZIGGURAT_R 3.442619855899                // Borde de la última capa
+#define ZIGGURAT_V 9.91256303526217e-3           // Área común de cada capa
+
+#define PHILOX_M0 0xD2511F53U                   // Multiplicadores y constantes de Weyl de Philox4x32
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+// FUNCIONES GENERADOR UNIFORME
+static inline uint64_t rotl64(uint64_t value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+// splitmix64: expande la semilla a los 256 bits de estado (nunca todo ceros)
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void init_ziggurat_tables(RngState *rng)
+{
+    // Tablas del Ziggurat: ZIGGURAT_LAYERS capas de igual área bajo exp(-x^2 / 2)
+    const double m1 = 2147483648.0;
+    double dn = ZIGGURAT_R, tn = dn;
+    double q = ZIGGURAT_V / exp(-0.5 * dn * dn);
+
+    rng->ziggurat_k[0] = (uint32_t)((dn / q) * m1);
+    rng->ziggurat_k[1] = 0;
+    rng->ziggurat_w[0] = (float)(q / m1);
+    rng->ziggurat_w[ZIGGURAT_LAYERS - 1] = (float)(dn / m1);
+    rng->ziggurat_f[0] = 1.0f;
+    rng->ziggurat_f[ZIGGURAT_LAYERS - 1] = (float)exp(-0.5 * dn * dn);
+
+    for (int i = ZIGGURAT_LAYERS - 2; i >= 1; i--)
+    {
+        dn = sqrt(-2.0 * log(ZIGGURAT_V / dn + exp(-0.5 * dn * dn)));
+        rng->ziggurat_k[i + 1] = (uint32_t)((dn / tn) * m1);
+        tn = dn;
+        rng->ziggurat_f[i] = (float)exp(-0.5 * dn * dn);
+        rng->ziggurat_w[i] = (float)(dn / m1);
+    }
+
+    rng->initialized = true;
+}
+
+bool init_rng(RngState *rng, uint64_t seed)
+{
+    if (!rng)
+    {
+        printf("Error: Generador aleatorio no valido\n");
+        return true;
+    }
+
+    for (int i = 0; i < 4; i++) { rng->state[i] = splitmix64(&seed); }
+
+    init_ziggurat_tables(rng);
+
+    return false;
+}
+
+uint64_t rng_next_u64(RngState *rng)
+{
+    uint64_t *s = rng->state;
+    uint64_t result = rotl64(s[0] + s[3], 23) + s[0];
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+
+    return result;
+}
+
+// Uniforme en (0, 1): 24 bits altos con medio paso de desplazamiento (nunca 0 ni 1)
+float rng_uniform(RngState *rng)
+{
+    return ((float)(rng_next_u64(rng) >> 40) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+// Entero en [0, bound) por multiplicación (sesgo < bound / 2^32, sin la división de rand() % n)
+uint32_t rng_below(RngState *rng, uint32_t bound)
+{
+    return (uint32_t)(((rng_next_u64(rng) >> 32) * (uint64_t)bound) >> 32);
+}
+
+
+// FUNCIONES FLUJOS REPRODUCIBLES
+// Philox4x32 (Salmon et al., SC'11): biyección del contador por la clave, sin estado entre llamadas
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// El estado del flujo es Philox(semilla, (trama, etapa, subflujo)): cualquier trama se regenera
+// en cualquier hilo y orden. Las tablas del Ziggurat se conservan si el estado ya estaba iniciado.
+bool set_rng_stream(RngState *rng, uint64_t seed, uint64_t frame, RngStage stage, uint32_t substream)
+{
+    if (!rng)
+    {
+        printf("Error: Generador aleatorio no valido\n");
+        return true;
+    }
+
+    const uint32_t key[2] = { (uint32_t)seed, (uint32_t)(seed >> 32) };
+    uint32_t counter[4] = { (uint32_t)frame, (uint32_t)(frame >> 32), ((uint32_t)stage << 24) ^ substream, 0 };
+    uint32_t words[8];
+
+    // Dos bloques (palabra 3 = 0 / 1) cubren los 256 bits de xoshiro256++
+    philox4x32(counter, key, &words[0]);
+    counter[3] = 1;
+    philox4x32(counter, key, &words[4]);
+
+    uint64_t any = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        rng->state[i] = ((uint64_t)words[2 * i + 1] << 32) | words[2 * i];
+        any |= rng->state[i];
+    }
+
+    // Estado todo ceros no válido en xoshiro (probabilidad 2^-256)
+    if (!any) rng->state[0] = 1;
+
+    if (!rng->initialized) init_ziggurat_tables(rng);
+
+    return false;
+}
+
+
+// FUNCIONES GENERADOR GAUSSIANO
+// Rama lenta (~1.2 % de las muestras): cola más allá de R o zona curva de la capa
+static float ziggurat_fix(RngState *rng, int32_t hz, uint32_t iz)
+{
+    while (true)
+    {
+        float x = (float)hz * rng->ziggurat_w[iz];
+
+        if (iz == 0)
+        {
+            // Cola: método de Marsaglia para x > R
+            float tail_x, tail_y;
+            do
+            {
+                tail_x = -logf(rng_uniform(rng)) / (float)ZIGGURAT_R;
+                tail_y = -logf(rng_uniform(rng));
+            } while (tail_y + tail_y < tail_x * tail_x);
+
+            return (hz > 0) ? (float)ZIGGURAT_R + tail_x : -(float)ZIGGURAT_R - tail_x;
+        }
+
+        if (rng->ziggurat_f[iz] + rng_uniform(rng) * (rng->ziggurat_f[iz - 1] - rng->ziggurat_f[iz]) <
+            expf(-0.5f * x * x))
+        {
+            return x;
+        }
+
+        hz = (int32_t)(uint32_t)(rng_next_u64(rng) >> 32);
+        iz = (uint32_t)hz & (ZIGGURAT_LAYERS - 1);
+        if ((uint32_t)llabs((long long)hz) < rng->ziggurat_k[iz]) return (float)hz * rng->ziggurat_w[iz];
+    }
+}
+
+// Una muestra a partir de 32 bits aleatorios: capa con los 7 bits bajos, posición con el resto
+static inline float ziggurat_sample(RngState *rng, uint32_t bits)
+{
+    int32_t hz = (int32_t)bits;
+    uint32_t iz = bits & (ZIGGURAT_LAYERS - 1);
+
+    // Camino rápido: dentro del rectángulo de la capa (sin exp, log ni trigonometría)
+    if ((uint32_t)llabs((long long)hz) < rng->ziggurat_k[iz]) return (float)hz * rng->ziggurat_w[iz];
+
+    return ziggurat_fix(rng, hz, iz);
+}
+
+float rng_gaussian(RngState *rng)
+{
+    return ziggurat_sample(rng, (uint32_t)(rng_next_u64(rng) >> 32));
+}
+
+void rng_fill_gaussian(RngState *rng, float out[], int length, float stddev)
+{
+    int i = 0;
+
+    // Dos muestras por cada salida de 64 bits de xoshiro256++
+    for (; i + 1 < length; i += 2)
+    {
+        uint64_t bits = rng_next_u64(rng);
+        out[i] = ziggurat_sample(rng, (uint32_t)(bits >> 32)) * stddev;
+        out[i + 1] = ziggurat_sample(rng, (uint32_t)bits) * stddev;
+    }
+
+    if (i < length) out[i] = rng_gaussian(rng) * stddev;
+}
+
+void rng_fill_complex_gaussian(RngState *rng, float complex out[], int length, float stddev)
+{
+    for (int i = 0; i < length; i++)
+    {
+        uint64_t bits = rng_next_u64(rng);
+        float re = ziggurat_sample(rng, (uint32_t)(bits >> 32));
+        float im = ziggurat_sample(rng, (uint32_t)bits);
+        out[i] = re * stddev + im * stddev * I;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef GAM_RNG_H
+#define GAM_RNG_H
+
+#include "../../MODULES/Common.h"
+
+
+// GENERADOR UNIFORME (xoshiro256++, estado propio por instancia: sin estado global compartido)
+bool init_rng(RngState *rng, uint64_t seed);
+
+uint64_t rng_next_u64(RngState *rng);
+
+float rng_uniform(RngState *rng);
+
+uint32_t rng_below(RngState *rng, uint32_t bound);
+
+
+// FLUJOS REPRODUCIBLES (Philox4x32: clave = semilla, contador = trama / etapa / subflujo)
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+// Requiere un estado iniciado con init_rng (o a cero): solo se reescriben los 256 bits de estado
+bool set_rng_stream(RngState *rng, uint64_t seed, uint64_t frame, RngStage stage, uint32_t substream);
+
+
+// GENERADOR GAUSSIANO (Ziggurat de Marsaglia-Tsang, N(0, 1))
+float rng_gaussian(RngState *rng);
+
+void rng_fill_gaussian(RngState *rng, float out[], int length, float stddev);
+
+void rng_fill_complex_gaussian(RngState *rng, float complex out[], int length, float stddev);
+
+
+#endif //GAM_RNG_H
@@ -345,4 +345,39 @@ bool apply_sco_compensation(PRB_Grid *grid, SCOTracker *tracker)
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+
+// FUNCIONES VARIANZA DE RUIDO
+bool estimate_pilot_noise_variance(const float complex received_pilots[PRB_SYMBOLS][PILOTS_PER_SYMBOL],
+                                   float *noise_variance)
+{
+    if (!noise_variance)
+    {
+        printf("Error: Salida de varianza de ruido no valida\n");
+        return true;
+    }
+
+    // Ganancia común h = media(p_rx / p_ref); el residuo p_rx - h·p_ref es ruido
+    float complex gain = 0.0f + 0.0f * I;
+    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    {
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++) {   gain += received_pilots[sym][p] / PILOT_VALUE;   }
+    }
+    gain /= (float)TOTAL_PILOTS;
+
+    float residual = 0.0f;
+    for (int sym = 0; sym < PRB_SYMBOLS; sym++)
+    {
+        for (int p = 0; p < PILOTS_PER_SYMBOL; p++)
+        {
+            float complex e = received_pilots[sym][p] - gain * PILOT_VALUE;
+            residual += crealf(e) * crealf(e) + cimagf(e) * cimagf(e);
+        }
+    }
+
+    // Un grado de libertad complejo consumido por la ganancia
+    *noise_variance = residual / (float)(TOTAL_PILOTS - 1);
+
+    return false;
+}
@@ -21,6 +21,11 @@ bool estimate_sco(const float complex current_pilots[PRB_SYMBOLS][PILOTS_PER_SYM
                   const float complex previous_pilots[PRB_SYMBOLS][PILOTS_PER_SYMBOL], SCOTracker *tracker);
 
 
+// Varianza del ruido complejo en los pilotos (residuo tras ajustar una ganancia común)
+bool estimate_pilot_noise_variance(const float complex received_pilots[PRB_SYMBOLS][PILOTS_PER_SYMBOL],
+                                   float *noise_variance);
+
+
 //CORREGIR
 bool apply_cfo_residual_correction(PRB_Grid *grid, CFOResidualTracker *tracker);
 
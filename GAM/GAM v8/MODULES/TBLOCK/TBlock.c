@@ -78,6 +78,22 @@ bool deinterleave_bits(const int input_bits[TOTAL_BITS_REPEATED], int output_bit
     return false;
 }
 
+bool deinterleave_llrs(const float input_llrs[TOTAL_BITS_REPEATED], float output_llrs[TOTAL_BITS_REPEATED]) {
+    if (TOTAL_BITS_REPEATED != INTERLEAVER_SIZE) {
+        printf("Error: Tamaño de entrelazado no coincide\n");
+        return true;
+    }
+
+    // Misma permutación que deinterleave_bits: entrada por columnas, salida por filas
+    for (int i = 0; i < INTERLEAVER_ROWS; i++) {
+        for (int j = 0; j < INTERLEAVER_COLS; j++) {
+            output_llrs[i * INTERLEAVER_COLS + j] = input_llrs[j * INTERLEAVER_ROWS + i];
+        }
+    }
+
+    return false;
+}
+
 
 // FUNCIONES TRANSPORT BLOCK
 bool build_transport_block(TransportBlock *tb, const int data_bits[TB_SIZE_BITS]) {
@@ -93,9 +109,9 @@ bool build_transport_block(TransportBlock *tb, const int data_bits[TB_SIZE_BITS]
     for (int i = 0; i < CRC_TYPE; i++)
         tb->total_bits[idx++] = tb->crc_bits[i];
 
-    // Repetición simple (1:1 para prueba)
-    for (int i = 0; i < TOTAL_BITS; i++) {
-        tb->repeated_bits[i] = tb->total_bits[i];
+    // Repetición simple: REPETITION_FACTOR copias consecutivas (el RX usa la primera)
+    for (int i = 0; i < TOTAL_BITS_REPEATED; i++) {
+        tb->repeated_bits[i] = tb->total_bits[i % TOTAL_BITS];
     }
 
     interleave_bits(tb->repeated_bits, tb->interleaved_bits);
@@ -121,3 +137,25 @@ bool process_received_block(const int received_bits[TOTAL_BITS_REPEATED], Transp
 
     return !tb->crc_valid;
 }
+
+// Las REPETITION_FACTOR copias se combinan sumando LLRs (máxima verosimilitud para la repetición)
+bool process_received_block_soft(const float received_llrs[TOTAL_BITS_REPEATED], TransportBlock *tb) {
+    float deinterleaved_llrs[TOTAL_BITS_REPEATED];
+    if (deinterleave_llrs(received_llrs, deinterleaved_llrs)) return true;
+
+    for (int i = 0; i < TOTAL_BITS; i++) {
+        float combined = 0.0f;
+        for (int r = 0; r < REPETITION_FACTOR; r++)
+            combined += deinterleaved_llrs[r * TOTAL_BITS + i];
+        tb->total_bits[i] = (combined < 0.0f) ? 1 : 0;
+    }
+
+    for (int i = 0; i < TB_SIZE_BITS; i++)
+        tb->data_bits[i] = tb->total_bits[i];
+    for (int i = 0; i < CRC_TYPE; i++)
+        tb->crc_bits[i] = tb->total_bits[TB_SIZE_BITS + i];
+
+    tb->crc_valid = verify_crc24a(tb->total_bits);
+
+    return !tb->crc_valid;
+}
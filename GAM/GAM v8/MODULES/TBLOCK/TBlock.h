@@ -12,11 +12,13 @@ bool verify_crc24a(const int received_bits[TOTAL_BITS]);
 // ENTRELAZADO
 bool interleave_bits(const int input_bits[TOTAL_BITS_REPEATED], int output_bits[TOTAL_BITS_REPEATED]);
 bool deinterleave_bits(const int input_bits[TOTAL_BITS_REPEATED], int output_bits[TOTAL_BITS_REPEATED]);
+bool deinterleave_llrs(const float input_llrs[TOTAL_BITS_REPEATED], float output_llrs[TOTAL_BITS_REPEATED]);
 
 
 // GESTIÓN DEL T-BLOCK
 bool build_transport_block(TransportBlock *tb, const int data_bits[TB_SIZE_BITS]);
 bool process_received_block(const int received_bits[TOTAL_BITS_REPEATED], TransportBlock *tb);
+bool process_received_block_soft(const float received_llrs[TOTAL_BITS_REPEATED], TransportBlock *tb);
 
 
 #endif //GAM_TRANSPORT_BLOCK_H